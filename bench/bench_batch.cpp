@@ -0,0 +1,141 @@
+// Conversion of mixed-unit plain requests: one at a time through the plan
+// of its unit pair (lookup, then evaluate), against a RequestBatch grouped
+// by unit pair. Then the same batches encoded into 16-bit storage codes
+// (float16, bfloat16, fixed16), error reports included.
+//
+// Usage: bench_batch [millions of rows]   (default 4)
+#include "../include/Plan.hpp"
+#include "../include/RequestBatch.hpp"
+#include "../include/Unit.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Rows {
+    std::vector<float> values;
+    std::vector<UnitId> from;
+    std::vector<UnitId> to;
+};
+
+// Lignes de paires tirées au hasard parmi `distinct` paires du registre
+// (toutes si 0): leur ordre ne se répète pas
+Rows input(size_t count, size_t distinct) {
+    std::vector<std::pair<UnitId, UnitId>> pairs;
+    for (const auto &[a, typeA] : UnitSet) {
+        for (const auto &[b, typeB] : UnitSet) {
+            if (pairId(*unitId(a), *unitId(b)).has_value()) {
+                pairs.emplace_back(*unitId(a), *unitId(b));
+            }
+        }
+    }
+    std::mt19937_64 rng(20241018);
+    std::shuffle(pairs.begin(), pairs.end(), rng);
+    if (distinct != 0) {
+        pairs.resize(distinct);
+    }
+    std::uniform_real_distribution<float> value(0.1f, 5000.0f);
+
+    Rows rows;
+    for (size_t i = 0; i < count; i++) {
+        auto [from, to] = pairs[rng() % pairs.size()];
+        rows.values.push_back(value(rng));
+        rows.from.push_back(from);
+        rows.to.push_back(to);
+    }
+    return rows;
+}
+
+// Meilleur de 5 passes, en millions de lignes par seconde
+template <typename F> void measure(const char *name, size_t count, F run) {
+    double best = 0.0;
+    double checksum = 0.0;
+    for (int pass = 0; pass < 5; pass++) {
+        auto start = std::chrono::steady_clock::now();
+        checksum = run();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = std::max(best, count / 1e6 / elapsed.count());
+    }
+    std::printf("  %-26s %8.1f M rows/s  (checksum %g)\n", name, best,
+                checksum);
+}
+
+void run(size_t count, size_t distinct) {
+    Rows rows = input(count, distinct);
+    std::vector<float> out(count);
+    if (distinct == 0) {
+        std::printf("Every unit pair of the registry:\n");
+    } else {
+        std::printf("%zu unit pairs:\n", distinct);
+    }
+
+    // Une ligne à la fois: coefficients de sa paire, puis le noyau sur une
+    // seule valeur
+    measure("row by row", count, [&] {
+        for (size_t i = 0; i < count; i++) {
+            auto pair = pairId(rows.from[i], rows.to[i]);
+            applyCoefficients(pairCoefficients(*pair), &rows.values[i], 1,
+                              &out[i]);
+        }
+        return static_cast<double>(out[count / 2]);
+    });
+
+    // Lots de BATCH_LINES lignes, comme le mode fichier, puis un seul lot
+    for (size_t batchRows : {size_t{1024}, count}) {
+        RequestBatch batch;
+        measure(batchRows == count ? "RequestBatch, one batch"
+                                   : "RequestBatch, 1024 rows",
+                count, [&] {
+                    for (size_t begin = 0; begin < count; begin += batchRows) {
+                        size_t end = std::min(count, begin + batchRows);
+                        batch.clear();
+                        for (size_t i = begin; i < end; i++) {
+                            (void)batch.push(rows.values[i], rows.from[i],
+                                             rows.to[i]);
+                        }
+                        batch.convert(out.data() + begin);
+                    }
+                    return static_cast<double>(out[count / 2]);
+                });
+    }
+
+    // Codes de 16 bits: l'encodage et le rapport d'erreur dans le noyau
+    std::vector<uint16_t> codes(count);
+    std::vector<ColumnReport> report;
+    const std::pair<StorageFormat, const char *> formats[] = {
+        {StorageFormat::FLOAT16, "RequestBatch, float16"},
+        {StorageFormat::BFLOAT16, "RequestBatch, bfloat16"},
+        {StorageFormat::FIXED16, "RequestBatch, fixed16"}};
+    for (auto [format, name] : formats) {
+        RequestBatch batch;
+        measure(name, count, [&, format = format] {
+            for (size_t begin = 0; begin < count; begin += 1024) {
+                size_t end = std::min(count, begin + 1024);
+                batch.clear();
+                for (size_t i = begin; i < end; i++) {
+                    (void)batch.push(rows.values[i], rows.from[i],
+                                     rows.to[i]);
+                }
+                batch.convert(format, codes.data() + begin, report);
+            }
+            return static_cast<double>(codes[count / 2]);
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t millions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4;
+    std::printf("Mixed-unit conversion of %zu M rows\n", millions);
+    for (size_t distinct : {8, 64, 0}) {
+        run(millions * 1000000, distinct);
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Lexer throughput on generated requests: token boundaries found by
+// the former byte loop (<cctype>, one byte at a time), by the ByteClass
+// table one byte at a time and by SpanScanner (SSE2 blocks), then the
+// full StreamLexer.
+//
+// Usage: bench_lexer [megabytes]   (default 32)
+#include "../include/ByteClass.hpp"
+#include "../include/StreamLexer.hpp"
+#include "../include/Unit.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Requêtes aléatoires: valeurs de longueurs variées, unités du registre
+// (ASCII, UTF-8, avec chiffres), espacement irrégulier. Une entrée
+// périodique serait apprise par le prédicteur de branchements.
+std::string input(size_t bytes) {
+    std::vector<std::string_view> units;
+    for (const auto &[unit, type] : UnitSet) {
+        units.push_back(unit);
+    }
+    std::mt19937_64 rng(20241018);
+    auto pick = [&](size_t n) { return static_cast<size_t>(rng() % n); };
+
+    std::string text;
+    char number[32];
+    while (text.size() < bytes) {
+        std::snprintf(number, sizeof number, "%.*f",
+                      static_cast<int>(pick(4)),
+                      std::ldexp(static_cast<double>(rng() >> 11),
+                                 -static_cast<int>(pick(60))));
+        text.append("convert ").append(pick(4) == 0 ? "  " : "");
+        text.append(number).append(" ").append(units[pick(units.size())]);
+        text.append(" to ").append(units[pick(units.size())]);
+        if (pick(3) == 0) {
+            text.append(", ").append(units[pick(units.size())]);
+        }
+        text.append(pick(8) == 0 ? " \r\n" : "\n");
+    }
+    return text;
+}
+
+// Boucle octet par octet d'avant ByteClass
+size_t countByteLoop(std::string_view s) {
+    size_t tokens = 0;
+    size_t i = 0;
+    while (i < s.size()) {
+        auto c = static_cast<unsigned char>(s[i]);
+        if (std::isspace(c)) {
+            i++;
+            continue;
+        }
+        tokens++;
+        i++;
+        if (std::isdigit(c)) {
+            while (i < s.size() && (std::isdigit(static_cast<unsigned char>(
+                                        s[i])) ||
+                                    s[i] == '.')) {
+                i++;
+            }
+        } else if (std::isalpha(c) || c >= 0xC0) {
+            while (i < s.size() &&
+                   (std::isalpha(static_cast<unsigned char>(s[i])) ||
+                    s[i] == '/' || (s[i] & 0x80) != 0)) {
+                i++;
+            }
+        }
+    }
+    return tokens;
+}
+
+// Mêmes frontières avec la table ByteClass, octet par octet ou par blocs
+template <bool Vector> size_t countClassified(std::string_view s) {
+    SpanScanner scanner(s);
+    auto run = [&](auto classes, size_t from) {
+        constexpr uint8_t CLASSES = decltype(classes)::value;
+        if constexpr (Vector) {
+            return scanner.span<CLASSES>(from);
+        } else {
+            return spanScalar<CLASSES>(s, from);
+        }
+    };
+    using Digits = std::integral_constant<uint8_t, ByteClass::DIGIT>;
+    using Spaces = std::integral_constant<uint8_t, ByteClass::SPACE>;
+    using Word = std::integral_constant<uint8_t,
+                                        ByteClass::ALPHA | ByteClass::DIGIT>;
+    constexpr uint8_t WORD_START = ByteClass::ALPHA | ByteClass::UTF8_LEAD;
+    constexpr uint8_t NON_ASCII = ByteClass::UTF8_LEAD | ByteClass::UTF8_CONT;
+
+    size_t tokens = 0;
+    size_t i = 0;
+    while (i < s.size()) {
+        uint8_t cls = byteClass(s[i]);
+        if ((cls & (ByteClass::SPACE | ByteClass::NEWLINE)) != 0) {
+            i = run(Spaces(), i + 1);
+            continue;
+        }
+        tokens++;
+        i++;
+        if (cls == ByteClass::DIGIT) {
+            i = run(Digits(), i);
+            if (i < s.size() && s[i] == '.') {
+                i = run(Digits(), i + 1);
+            }
+        } else if ((cls & WORD_START) != 0) {
+            while (i < s.size()) {
+                cls = byteClass(s[i]);
+                if ((cls & Word::value) != 0) {
+                    i = run(Word(), i);
+                } else if (s[i] == '/' || (cls & NON_ASCII) != 0) {
+                    i++;
+                } else {
+                    break;
+                }
+            }
+        }
+    }
+    return tokens;
+}
+
+size_t countStreamLexer(std::string_view s) {
+    std::pmr::unsynchronized_pool_resource pool;
+    StreamLexer lexer(&pool);
+    TokenList line(&pool);
+    size_t tokens = 0;
+    while (lexer.next(s, line)) {
+        tokens += line.size();
+        line.clear();
+    }
+    lexer.finish(line);
+    return tokens + line.size();
+}
+
+// Meilleur de 5 passes, en Mo/s
+template <typename F> void measure(const char *name, std::string_view s,
+                                   F count) {
+    double best = 0.0;
+    size_t tokens = 0;
+    for (int run = 0; run < 5; run++) {
+        auto start = std::chrono::steady_clock::now();
+        tokens = count(s);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = std::max(best, s.size() / 1e6 / elapsed.count());
+    }
+    std::printf("  %-22s %8.0f MB/s  (%zu tokens)\n", name, best, tokens);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 32;
+    std::string text = input(megabytes << 20);
+    std::printf("Lexer throughput on %zu MB:\n", text.size() >> 20);
+
+    measure("byte loop (cctype)", text, countByteLoop);
+    measure("ByteClass, scalar", text, countClassified<false>);
+    measure("ByteClass, SSE2 blocks", text, countClassified<true>);
+    measure("StreamLexer", text, countStreamLexer);
+    return 0;
+}
@@ -0,0 +1,96 @@
+"""Python module against pure NumPy: one unit pair, then rows of mixed unit
+pairs, on float32 arrays.
+
+Usage: PYTHONPATH=build python3 bench/bench_python.py [millions of rows]
+
+Exits with 77 (skipped) when NumPy is not installed.
+"""
+import sys
+import time
+
+try:
+    import numpy as np
+except ImportError:
+    print("NumPy not installed, benchmark skipped")
+    sys.exit(77)
+
+import convertisseur as cv
+
+
+def measure(name, count, run):
+    """Best of 5 runs, in millions of rows per second."""
+    best = 0.0
+    for _ in range(5):
+        start = time.perf_counter()
+        run()
+        best = max(best, count / 1e6 / (time.perf_counter() - start))
+    print(f"  {name:<34} {best:8.1f} M rows/s")
+
+
+def single_pair(count):
+    print(f"km → mi, {count // 1000000} M rows:")
+    rng = np.random.default_rng(20241018)
+    values = rng.uniform(0.1, 5000.0, count).astype(np.float32)
+    out = np.empty_like(values)
+    scale = cv.coefficients("km", "mi")[1]
+
+    # Multiplication en float32: un arrondi de plus que le module
+    factor = np.float32(scale)
+    measure("NumPy float32 multiply", count,
+            lambda: np.multiply(values, factor, out=out))
+    # Même calcul que le noyau: double, un seul arrondi vers float32
+    measure("NumPy float64 multiply", count,
+            lambda: np.multiply(values, scale, out=out, dtype=np.float64,
+                                casting="unsafe"))
+    measure("convertisseur.convert", count,
+            lambda: cv.convert(values, "km", "mi", out))
+
+    expected = (values.astype(np.float64) * scale).astype(np.float32)
+    cv.convert(values, "km", "mi", out)
+    assert np.array_equal(out, expected)
+
+
+def mixed_pairs(count, distinct):
+    print(f"{distinct} linear unit pairs, {count // 1000000} M rows:")
+    rng = np.random.default_rng(20241018)
+    # Paires linéaires: NumPy les convertit par une table de facteurs
+    linear = [(a, b) for a in cv.units() for b in cv.units()
+              if a != b and " " not in a and " " not in b
+              and _kind(a, b) == "linear"]
+    chosen = [linear[i] for i in rng.choice(len(linear), distinct, False)]
+    rows = rng.integers(0, distinct, count)
+    from_ids = np.array([cv.unit_id(a) for a, _ in chosen],
+                        dtype=np.uint16)[rows]
+    to_ids = np.array([cv.unit_id(b) for _, b in chosen],
+                      dtype=np.uint16)[rows]
+    values = rng.uniform(0.1, 5000.0, count).astype(np.float32)
+    out = np.empty_like(values)
+
+    units = len(cv.units())
+    factors = np.zeros((units, units))
+    for a, b in chosen:
+        factors[cv.unit_id(a), cv.unit_id(b)] = cv.coefficients(a, b)[1]
+
+    measure("NumPy factor table gather", count,
+            lambda: np.multiply(values, factors[from_ids, to_ids], out=out,
+                                dtype=np.float64, casting="unsafe"))
+    measure("convertisseur.convert_mixed", count,
+            lambda: cv.convert_mixed(values, from_ids, to_ids, out))
+
+    expected = (values * factors[from_ids, to_ids]).astype(np.float32)
+    cv.convert_mixed(values, from_ids, to_ids, out)
+    assert np.array_equal(out, expected)
+
+
+def _kind(a, b):
+    try:
+        return cv.coefficients(a, b)[0]
+    except ValueError:
+        return None
+
+
+if __name__ == "__main__":
+    millions = int(sys.argv[1]) if len(sys.argv) > 1 else 10
+    single_pair(millions * 1000000)
+    for distinct in (8, 64):
+        mixed_pairs(millions * 1000000, distinct)
@@ -0,0 +1,170 @@
+// Latency of one sample through the converter: binary records over
+// shared-memory rings against text lines over pipes, each time with the
+// converter in a child process, as with --ring and --file -.
+//
+// Ping-pong: the producer sends one sample and waits for its result before
+// sending the next. Then a stream: the producer sends samples as fast as
+// the rings accept them.
+//
+// Usage: bench_ring [thousands of samples]   (default 100)
+#include "../include/Convertisseur.hpp"
+#include "../include/ShmRing.hpp"
+#include "../include/Unit.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Percentiles d'une série de latences, en microsecondes
+void report(const char *name, std::vector<double> &latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&](double q) {
+        return latencies[static_cast<size_t>(q * (latencies.size() - 1))];
+    };
+    std::printf("  %-22s p50 %7.2f us   p99 %7.2f us   max %8.2f us\n", name,
+                at(0.5), at(0.99), latencies.back());
+}
+
+// Attente du producteur: comme RingConverter, pas d'appel système tant
+// que le convertisseur répond vite
+void wait(unsigned &idle) {
+    if (++idle >= 64) {
+        std::this_thread::yield();
+    }
+}
+
+void ringPingPong(size_t count, UnitId km, UnitId mi) {
+    std::string inName = "/bench-ring-in-" + std::to_string(getpid());
+    std::string outName = "/bench-ring-out-" + std::to_string(getpid());
+    ShmRing input = ShmRing::create(inName, 1 << 12);
+    ShmRing output = ShmRing::create(outName, 1 << 12);
+
+    pid_t child = fork();
+    if (child == 0) {
+        ShmRing in = ShmRing::attach(inName);
+        ShmRing out = ShmRing::attach(outName);
+        RingConverter(in, out).run();
+        _exit(0);
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(count);
+    SampleRecord result{};
+    for (size_t i = 0; i < count; i++) {
+        auto start = Clock::now();
+        (void)input.push(SampleRecord{static_cast<float>(i), km, mi});
+        unsigned idle = 0;
+        while (output.pop(&result, 1) == 0) {
+            wait(idle);
+        }
+        std::chrono::duration<double, std::micro> elapsed =
+            Clock::now() - start;
+        latencies.push_back(elapsed.count());
+    }
+    report("ring ping-pong", latencies);
+
+    // Flux: envoi et réception entrelacés, aucun record en attente ne bloque
+    std::vector<SampleRecord> results(256);
+    auto start = Clock::now();
+    size_t sent = 0;
+    size_t received = 0;
+    unsigned idle = 0;
+    while (received < count) {
+        size_t before = sent + received;
+        while (sent < count &&
+               input.push(SampleRecord{static_cast<float>(sent), km, mi})) {
+            if (++sent == count) {
+                input.close();
+            }
+        }
+        received += output.pop(results.data(), results.size());
+        if (sent + received == before) {
+            wait(idle);
+        } else {
+            idle = 0;
+        }
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    std::printf("  %-22s %7.2f M samples/s\n", "ring stream",
+                count / 1e6 / elapsed.count());
+
+    waitpid(child, nullptr, 0);
+    ShmRing::remove(inName);
+    ShmRing::remove(outName);
+}
+
+void pipePingPong(size_t count) {
+    int requests[2];
+    int results[2];
+    if (pipe(requests) != 0 || pipe(results) != 0) {
+        std::perror("pipe");
+        std::exit(1);
+    }
+
+    // Le mode texte actuel: une ligne lue, lexée, parsée, convertie et
+    // formatée par requête
+    pid_t child = fork();
+    if (child == 0) {
+        close(requests[1]);
+        close(results[0]);
+        FILE *in = fdopen(requests[0], "r");
+        FILE *out = fdopen(results[1], "w");
+        char line[128];
+        std::ostringstream text;
+        PlanCache plans;
+        while (std::fgets(line, sizeof line, in) != nullptr) {
+            text.str("");
+            Convertisseur(line, plans).convert(text);
+            std::fputs(text.str().c_str(), out);
+            std::fflush(out);
+        }
+        _exit(0);
+    }
+    close(requests[0]);
+    close(results[1]);
+    FILE *in = fdopen(results[0], "r");
+
+    std::vector<double> latencies;
+    latencies.reserve(count);
+    char line[128];
+    for (size_t i = 0; i < count; i++) {
+        std::string request = "convert " + std::to_string(i) + " km to mi\n";
+        auto start = Clock::now();
+        if (write(requests[1], request.data(), request.size()) < 0 ||
+            std::fgets(line, sizeof line, in) == nullptr) {
+            std::perror("pipe");
+            std::exit(1);
+        }
+        std::chrono::duration<double, std::micro> elapsed =
+            Clock::now() - start;
+        latencies.push_back(elapsed.count());
+    }
+    report("text pipe ping-pong", latencies);
+
+    close(requests[1]);
+    std::fclose(in);
+    waitpid(child, nullptr, 0);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t thousands = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+    size_t count = thousands * 1000;
+    std::printf("Latency of %zu k samples, km → mi, converter in a child "
+                "process\n",
+                thousands);
+    ringPingPong(count, *unitId("km"), *unitId("mi"));
+    pipePingPong(count);
+    return 0;
+}
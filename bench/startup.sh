@@ -0,0 +1,62 @@
+#!/bin/bash
+# Startup benchmark: time to first result of one-shot CLI invocations
+#
+# Usage: bench/startup.sh [binary] [runs]
+#   BUDGET_MS=<ms>   fail if the median exceeds the budget
+#   RECORD=<file>    append "<version>,<median ms>,<min ms>" to a CSV file
+#
+# Uses hyperfine when installed, otherwise a plain timing loop.
+
+set -e
+
+BINARY=${1:-./build/Convertisseur}
+RUNS=${2:-200}
+REQUEST="convert 1.3 kg to lb"
+
+if [ ! -x "$BINARY" ]; then
+    echo "Error: $BINARY not found, build the project first" >&2
+    exit 1
+fi
+
+VERSION=$(git describe --tags --always --dirty 2>/dev/null || echo unknown)
+
+if command -v hyperfine >/dev/null; then
+    EXPORT=$(mktemp)
+    hyperfine --warmup 20 --runs "$RUNS" -N --export-json "$EXPORT" \
+        "$BINARY '$REQUEST'"
+    read -r MEDIAN MIN < <(python3 -c "
+import json, sys
+r = json.load(open('$EXPORT'))['results'][0]
+print(f\"{r['median'] * 1000:.3f} {r['min'] * 1000:.3f}\")")
+    rm -f "$EXPORT"
+else
+    # Timing each run would add two forks of date: time batches of runs
+    # and keep the mean of each batch
+    for _ in $(seq 20); do "$BINARY" "$REQUEST" >/dev/null; done
+    BATCHES=10
+    PER_BATCH=$(( (RUNS + BATCHES - 1) / BATCHES ))
+    TIMES=()
+    for _ in $(seq "$BATCHES"); do
+        start=$(date +%s%N)
+        for _ in $(seq "$PER_BATCH"); do
+            "$BINARY" "$REQUEST" >/dev/null
+        done
+        end=$(date +%s%N)
+        TIMES+=($(( (end - start) / PER_BATCH / 1000 )))
+    done
+    read -r MEDIAN MIN < <(printf '%s\n' "${TIMES[@]}" | sort -n | awk '
+        { t[NR] = $1 }
+        END { printf "%.3f %.3f\n", t[int((NR + 1) / 2)] / 1000, t[1] / 1000 }')
+fi
+
+echo "Startup ($VERSION, $RUNS runs): median ${MEDIAN} ms, min ${MIN} ms"
+
+if [ -n "$RECORD" ]; then
+    echo "$VERSION,$MEDIAN,$MIN" >> "$RECORD"
+fi
+
+if [ -n "$BUDGET_MS" ] &&
+    awk -v m="$MEDIAN" -v b="$BUDGET_MS" 'BEGIN { exit !(m > b) }'; then
+    echo "Error: median startup ${MEDIAN} ms exceeds budget ${BUDGET_MS} ms" >&2
+    exit 1
+fi
@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * @class AsyncIO
+ * @brief Overlapped block input and buffered output of the bulk mode over
+ *        io_uring
+ *
+ * Input is read in blocks of fixed size into buffers registered with the
+ * kernel. While the caller lexes and converts one block, the reads of the
+ * next ones are already in flight (up to `depth` blocks ahead for a
+ * regular file, one for a pipe, whose reads must stay in order). Output
+ * goes through the std::streambuf interface into one of two registered
+ * buffers; a full buffer is written while the other one fills. Pending
+ * reads and writes are submitted together, with a single io_uring_enter
+ * system call per wait.
+ *
+ * Flushing the stream (std::endl) does not write anything: output is
+ * written a buffer at a time, and by finish().
+ *
+ * Without io_uring (other systems, kernel older than 5.6, or disabled by a
+ * seccomp policy) or when asked to, the same interface uses blocking
+ * read() and write() calls, one block at a time.
+ *
+ * Usage:
+ *   AsyncIO io(input, STDOUT_FILENO);
+ *   std::ostream out(&io);
+ *   std::string_view block;
+ *   while (io.read(block)) {
+ *       process(block, out);
+ *   }
+ *   io.finish();
+ */
+class AsyncIO : public std::streambuf {
+  public:
+    /**
+     * @brief Constructor
+     * @param in Input file descriptor, read from its current position
+     * @param out Output file descriptor
+     * @param ring Use io_uring if the kernel allows it
+     * @param blockBytes Size of each read and write buffer
+     * @param depth Number of input blocks read ahead
+     */
+    AsyncIO(int in, int out, bool ring = true, size_t blockBytes = 64 * 1024,
+            unsigned depth = 4);
+
+    /// Writes the buffered output (errors ignored) and waits for every
+    /// operation in flight before releasing the buffers
+    ~AsyncIO() override;
+
+    AsyncIO(const AsyncIO &) = delete;
+    AsyncIO &operator=(const AsyncIO &) = delete;
+
+    /**
+     * @brief Next block of input, in order
+     * @param block Receives the bytes, valid until the next call
+     * @return false at the end of the input
+     * @throw std::runtime_error if a read fails
+     */
+    bool read(std::string_view &block);
+
+    /**
+     * @brief Writes the buffered output and waits until it is written
+     * @throw std::runtime_error if a write fails
+     */
+    void finish();
+
+    /// @brief true if io_uring is used, false for the blocking fallback
+    bool usesRing() const { return ringFd >= 0; }
+
+  protected:
+    int overflow(int c) override;
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+
+  private:
+    /// State of an input buffer
+    enum class Slot : uint8_t {
+        FREE,    ///< Available for a read
+        READING, ///< Read in flight
+        READY    ///< Filled, not yet handed to the caller
+    };
+
+    /// Sets up the ring; false if io_uring is unavailable
+    bool setupRing();
+
+    /// Queues the reads of the next blocks into the free buffers
+    void refill();
+
+    /// Queues a read into an input buffer, after the bytes it already holds
+    void queueRead(size_t slot);
+
+    /// Queues the write of the rest of the buffer being written
+    void queueWrite();
+
+    /// Next submission queue entry, cleared
+    io_uring_sqe *nextEntry();
+
+    /**
+     * @brief Submits the queued entries and handles the completions
+     * @param wait Completions to wait for (0: do not block)
+     */
+    void submit(unsigned wait);
+
+    /// Handles a completion of a read or of the write
+    void complete(uint64_t tag, int result);
+
+    /// Writes the put area, switching to the other output buffer
+    void flushBuffer();
+
+    /// Start of an input (0 to depth - 1) or output (depth, depth + 1)
+    /// buffer
+    char *buffer(size_t index) const {
+        return memory.get() + index * blockBytes;
+    }
+
+    int in;            ///< Input file descriptor
+    int out;           ///< Output file descriptor
+    size_t blockBytes; ///< Size of each buffer
+    unsigned depth;    ///< Input buffers
+    bool seekable;     ///< Input is a regular file: reads at offsets
+    int64_t inBase;    ///< Input position at construction
+    std::unique_ptr<char[]> memory; ///< depth input then two output buffers
+
+    // Lecture
+    std::vector<Slot> slots;     ///< State of each input buffer
+    std::vector<size_t> lengths; ///< Bytes held by each input buffer
+    std::vector<uint64_t> blocks; ///< Block number read into each buffer
+    uint64_t delivered = 0;      ///< Blocks handed to the caller
+    uint64_t requested = 0;      ///< Blocks whose read was queued
+    unsigned reading = 0;        ///< Reads in flight
+    bool holding = false;        ///< The caller holds block delivered - 1
+    bool endOfInput = false;     ///< A read returned 0 bytes
+
+    // Écriture
+    size_t filling;              ///< Output buffer of the put area
+    size_t written = 0;          ///< Bytes of the buffer being written done
+    size_t writeLength = 0;      ///< Bytes of the buffer being written
+    bool writing = false;        ///< A write is in flight
+    int failure = 0;             ///< errno of a failed operation, or 0
+
+    // Anneaux partagés avec le noyau
+    int ringFd = -1;             ///< io_uring instance, -1 if unused
+    bool fixed = false;          ///< Buffers are registered
+    void *sqRing = nullptr;      ///< Submission ring mapping
+    void *cqRing = nullptr;      ///< Completion ring mapping (may alias)
+    size_t sqRingBytes = 0;
+    size_t cqRingBytes = 0;
+    io_uring_sqe *entries = nullptr; ///< Submission queue entries
+    size_t entriesBytes = 0;
+    unsigned *sqTail = nullptr;
+    unsigned *sqMask = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned *cqMask = nullptr;
+    io_uring_cqe *completions = nullptr;
+    unsigned queued = 0;         ///< Entries queued, not yet submitted
+};
@@ -0,0 +1,186 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Lexical classes of the input bytes, as bit flags
+ *
+ * Fixed ASCII classes: unlike std::isalpha and friends, they never depend
+ * on the process locale, and a class test is a single table load.
+ */
+namespace ByteClass {
+enum : uint8_t {
+    DIGIT = 1 << 0,      ///< '0'-'9'
+    ALPHA = 1 << 1,      ///< 'a'-'z', 'A'-'Z'
+    SPACE = 1 << 2,      ///< ' ', '\t', '\r', '\v', '\f' (not '\n')
+    NEWLINE = 1 << 3,    ///< '\n'
+    OPERATOR = 1 << 4,   ///< '+', '-', '*', '/', '(', ')'
+    SEPARATOR = 1 << 5,  ///< ','
+    UTF8_LEAD = 1 << 6,  ///< First byte of a valid UTF-8 sequence (C2-F4)
+    UTF8_CONT = 1 << 7   ///< Continuation byte (80-BF)
+};
+} // namespace ByteClass
+
+/// @brief Class of every byte value
+inline constexpr std::array<uint8_t, 256> BYTE_CLASSES = [] {
+    std::array<uint8_t, 256> table{};
+    for (int c = '0'; c <= '9'; c++) {
+        table[c] = ByteClass::DIGIT;
+    }
+    for (int c = 'a'; c <= 'z'; c++) {
+        table[c] = ByteClass::ALPHA;
+        table[c - 'a' + 'A'] = ByteClass::ALPHA;
+    }
+    for (unsigned char c : {' ', '\t', '\r', '\v', '\f'}) {
+        table[c] = ByteClass::SPACE;
+    }
+    table['\n'] = ByteClass::NEWLINE;
+    for (unsigned char c : {'+', '-', '*', '/', '(', ')'}) {
+        table[c] = ByteClass::OPERATOR;
+    }
+    table[','] = ByteClass::SEPARATOR;
+    // C0, C1 (séquences trop longues) et F5-FF ne commencent aucun
+    // caractère valide
+    for (int c = 0x80; c <= 0xBF; c++) {
+        table[c] = ByteClass::UTF8_CONT;
+    }
+    for (int c = 0xC2; c <= 0xF4; c++) {
+        table[c] = ByteClass::UTF8_LEAD;
+    }
+    return table;
+}();
+
+/// @brief Class of a byte
+constexpr uint8_t byteClass(char c) {
+    return BYTE_CLASSES[static_cast<unsigned char>(c)];
+}
+
+/**
+ * @brief End of the run of bytes of the given ASCII classes, one byte at a
+ *        time
+ * @tparam Classes Union of DIGIT, ALPHA and SPACE
+ * @param bytes Input
+ * @param from Start of the run
+ * @return Index of the first byte from `from` outside Classes, or
+ *         bytes.size()
+ */
+template <uint8_t Classes>
+size_t spanScalar(std::string_view bytes, size_t from) {
+    while (from < bytes.size() && (byteClass(bytes[from]) & Classes) != 0) {
+        from++;
+    }
+    return from;
+}
+
+/**
+ * @class SpanScanner
+ * @brief Ends of runs of digits, word bytes or spaces in a buffer
+ *
+ * Tokens are a few bytes long: testing each run with vectors would load and
+ * compare 16 bytes to skip three. The buffer is instead classified once per
+ * 64-byte block (four SSE2 comparisons per class, on every x86-64 target)
+ * into one bit mask per class, and the end of a run is a bit scan in the
+ * mask of its block. The last bytes of the buffer, shorter than a block,
+ * and targets without SSE2 use spanScalar.
+ *
+ * Only classification is vectorized. The masks cover ASCII classes, so
+ * the ASCII bytes of a word are skipped a block at a time and never
+ * reach UTF-8 validation. That validation (StreamLexer) checks the
+ * non-ASCII bytes one at a time: unit symbols hold a few of them at most
+ * ("μm", "m³/s").
+ *
+ * Usage:
+ *   SpanScanner scanner(bytes);
+ *   size_t end = scanner.span<ByteClass::DIGIT>(start);
+ */
+class SpanScanner {
+  public:
+    /// Spans supported: DIGIT, ALPHA | DIGIT and SPACE
+    static constexpr uint8_t WORD = ByteClass::ALPHA | ByteClass::DIGIT;
+
+    /// @param bytes Buffer scanned, which must outlive the scanner
+    explicit SpanScanner(std::string_view bytes) : bytes(bytes) {};
+
+    /**
+     * @brief End of the run of bytes of the given classes
+     * @tparam Classes DIGIT, WORD or SPACE
+     * @param from Start of the run
+     * @return Same as spanScalar
+     */
+    template <uint8_t Classes> size_t span(size_t from) {
+        static_assert(Classes == ByteClass::DIGIT || Classes == WORD ||
+                          Classes == ByteClass::SPACE,
+                      "SpanScanner: DIGIT, WORD ou SPACE seulement");
+#if defined(__SSE2__)
+        while (from < bytes.size()) {
+            size_t start = from & ~size_t(63);
+            if (start + 64 > bytes.size()) {
+                break;
+            }
+            if (start != base) {
+                classify(start);
+            }
+            // Les bits au-delà du bloc sont nuls après le décalage: la fin
+            // du run est au plus la fin du bloc
+            uint64_t outside = ~(masks[index<Classes>()] >> (from - start));
+            from += outside == 0
+                        ? 64
+                        : static_cast<size_t>(__builtin_ctzll(outside));
+            if (from < start + 64) {
+                return from;
+            }
+        }
+#endif
+        return spanScalar<Classes>(bytes, from);
+    }
+
+  private:
+    template <uint8_t Classes> static constexpr size_t index() {
+        return Classes == ByteClass::DIGIT ? 0 : Classes == WORD ? 1 : 2;
+    }
+
+#if defined(__SSE2__)
+    // Octets de [lo, hi] (ASCII): comparaison signée, les octets >= 0x80
+    // sont négatifs et donc hors de tout intervalle ASCII
+    static __m128i inRange(__m128i v, char lo, char hi) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                             _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+    }
+
+    // Masques des 64 octets à partir de start
+    void classify(size_t start) {
+        masks[0] = masks[1] = masks[2] = 0;
+        for (size_t k = 0; k < 64; k += 16) {
+            __m128i v = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(bytes.data() + start + k));
+            __m128i digit = inRange(v, '0', '9');
+            // 'A'-'Z' et 'a'-'z' ne diffèrent que par le bit 0x20
+            __m128i alpha =
+                inRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+            // '\t', '\v', '\f', '\r' (pas '\n') et ' '
+            __m128i space = _mm_or_si128(
+                _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                                 inRange(v, '\t', '\r')),
+                _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+            auto bits = [](__m128i m) {
+                return static_cast<uint64_t>(
+                    static_cast<uint32_t>(_mm_movemask_epi8(m)));
+            };
+            masks[0] |= bits(digit) << k;
+            masks[1] |= bits(_mm_or_si128(digit, alpha)) << k;
+            masks[2] |= bits(space) << k;
+        }
+        base = start;
+    }
+#endif
+
+    std::string_view bytes;   ///< Buffer scanned
+    size_t base = SIZE_MAX;   ///< Start of the block classified in masks
+    uint64_t masks[3] = {};   ///< DIGIT, WORD and SPACE bits of the block
+};
@@ -1,47 +1,119 @@
 #pragma once
 #include "Lexer.hpp"
 #include "Parser.hpp"
+#include "Plan.hpp"
 #include "Unit.hpp"
+#include <memory_resource>
+#include <optional>
+#include <ostream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 /**
  * @class Convertisseur
  * @brief Main unit converter engine
  *
- * Combines Lexer and Parser to process user input, then performs
- * unit conversion calculations.
+ * Combines Lexer and Parser to process user input, then compiles the
+ * request into a ConversionPlan and evaluates it.
  *
  * Usage:
  *   Convertisseur conv("convert 1.3 kg to lb");
  *   float result = conv.convert();  // Prints: "1.3 kg = 2.86601 lb"
+ *
+ * Expressions are accepted as source: "convert 5 ft 11 in to cm",
+ * "convert 3 kg + 500 g to lb", "convert (1.5 + 2.3) kg to lb".
+ * Several targets may be listed: "convert 100 km/h to m/s, mph, knot".
+ *
+ * In bulk mode, pass a monotonic arena as memory resource: the tokens and
+ * the parsed request are then allocated from it, and the arena can be
+ * released once a batch of lines has been converted. Passing a PlanCache
+ * skips parsing for every request whose shape was already compiled.
  */
 class Convertisseur {
   public:
     /**
      * @brief Constructor: parses and validates the conversion request
      * @param input Conversion expression (e.g., "convert 100 m to ft")
-     * @throw std::runtime_error if parsing or validation fails
+     * @param mr Memory resource for the lexer/parser state
+     * @param options Lexing settings (e.g. lenient unit matching)
+     * @throw std::runtime_error if parsing or validation fails; unknown
+     *        units come with "did you mean" suggestions
+     */
+    Convertisseur(
+        std::string_view input,
+        std::pmr::memory_resource *mr = std::pmr::get_default_resource(),
+        LexerOptions options = {});
+
+    /**
+     * @brief Constructor reusing the plans of previous requests
+     * @param input Conversion expression (e.g., "convert 100 m to ft")
+     * @param plans Plans by request shape; a request whose shape is cached
+     *        is not parsed, otherwise its plan is compiled and cached
+     * @param mr Memory resource for the lexer/parser state
+     * @param options Lexing settings (e.g. lenient unit matching)
+     * @throw std::runtime_error if parsing, validation or compilation fails
      */
-    Convertisseur(const std::string &input);
+    Convertisseur(
+        std::string_view input, PlanCache &plans,
+        std::pmr::memory_resource *mr = std::pmr::get_default_resource(),
+        LexerOptions options = {});
+
+    /**
+     * @brief Constructor from a request already lexed (see StreamLexer)
+     * @param tokens Tokens of one request; the parser state is allocated
+     *        from their memory resource
+     * @param plans Plans by request shape, as above
+     * @throw std::runtime_error if parsing, validation or compilation fails
+     */
+    Convertisseur(TokenList tokens, PlanCache &plans);
 
     /**
      * @brief Performs the unit conversion
-     * @return The converted value
+     * @param out Stream the result line is printed to
+     * @return The value converted to the first target unit
      * @throw std::runtime_error if units are invalid or incompatible
      *
-     * Also prints result: "<value> <unit> = <result> <unit>"
+     * Also prints result: "<expression> = <result> <unit>", with one
+     * "= <result> <unit>" per target unit
      */
+    float convert(std::ostream &out);
+
+    /// Performs the unit conversion, printing to std::cout
     float convert();
 
+    /**
+     * @brief Performs the conversion to every target unit
+     * @param out Stream the result line is printed to
+     * @return One converted value per target, in request order
+     * @throw std::runtime_error if units are invalid or incompatible
+     *
+     * The source is evaluated once; prints the same line as convert().
+     */
+    std::vector<float> convertAll(std::ostream &out);
+
+    /// Performs the conversion to every target unit, printing to std::cout
+    std::vector<float> convertAll();
+
   private:
-    float convertWeight();     ///< Convert weight units (base: kg)
-    float convertDistance();   ///< Convert distance units (base: m)
-    float convertVolume();     ///< Convert volume units (base: L)
-    float convertTime();       ///< Convert time units (base: s)
-    float convertTemperatur(); ///< Convert temperature (base: °C)
-    float convertArea();       ///< Convert area units (base: m²)
-    float convertSpeed();      ///< Convert speed units (base: m/s)
-    float convertPressure();   ///< Convert pressure units (base: Pa)
-
-    ConversionRequest cr; ///< The parsed conversion request
+    /// Takes the plan of the request shape from plans, compiling it if new
+    void lookupPlan(PlanCache &plans);
+
+    /// Parses the tokens into cr
+    /// @throw std::runtime_error with suggestions for unknown units
+    void parse();
+
+    /// Describes the first unknown word of tokens with suggestions
+    static std::string unknownUnitHint(const TokenList &tokens);
+
+    /// Plan to evaluate, compiled on first use without a cache
+    const ConversionPlan &compiledPlan();
+
+    /// Prints the source expression, numbers formatted from slots
+    void printSource(std::ostream &out, const float *slots) const;
+
+    TokenList tokens;      ///< The lexed input
+    ConversionRequest cr;  ///< The parsed request (not set on a cache hit)
+    std::optional<ConversionPlan> ownPlan; ///< Plan compiled without cache
+    const ConversionPlan *plan = nullptr;  ///< Plan to evaluate
 };
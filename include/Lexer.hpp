@@ -1,7 +1,10 @@
 #pragma once
 #include "Unit.hpp"
 #include <cctype>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -9,58 +12,106 @@
  * @brief Token types recognized by the lexical analyzer
  */
 enum class TokenType {
-    KEYWORD, ///< Keywords: "convert", "to"
-    UNIT,    ///< Recognized unit names
-    DECIMAL, ///< Floating-point numbers
-    UNKNOWN  ///< Unknown tokens
+    KEYWORD,   ///< Keywords: "convert", "to"
+    UNIT,      ///< Recognized unit names
+    DECIMAL,   ///< Floating-point numbers
+    OPERATOR,  ///< Arithmetic: "+", "-", "*", "/", "(", ")"
+    SEPARATOR, ///< "," between target units
+    UNKNOWN    ///< Unknown tokens
 };
 
 /**
  * @struct Token
  * @brief Represents a single token in the input stream
+ *
+ * The value is a polymorphic string: it is allocated from the memory
+ * resource the token was created with (see Lexer).
  */
 struct Token {
-    TokenType type;    ///< The type of this token
-    std::string value; ///< The lexical value of this token
-    Token(TokenType t, const std::string &s) : type(t), value(s) {};
+    TokenType type;         ///< The type of this token
+    std::pmr::string value; ///< The lexical value of this token
+    Token(TokenType t, std::string_view s,
+          std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+        : type(t), value(s, mr) {};
+};
+
+/// @brief Token stream produced by the Lexer
+using TokenList = std::pmr::vector<Token>;
+
+/**
+ * @struct NumberFormat
+ * @brief How numbers are written in a stream
+ *
+ * "1 234,56" is read with {',', ' '}. A grouping separator must be
+ * followed by exactly three digits, otherwise it is not part of the number
+ * ("5 ft 11 in" stays two numbers). The process locale is never used.
+ */
+struct NumberFormat {
+    char decimal = '.'; ///< Decimal separator
+    char grouping = 0;  ///< Thousands separator, 0 for none
+};
+
+/**
+ * @struct LexerOptions
+ * @brief Per-stream lexing settings
+ */
+struct LexerOptions {
+    /// Lenient mode: a word that is not a unit is resolved ignoring case,
+    /// through the aliases ("feet" → "ft"), or to the only unit at edit
+    /// distance 1 ("kgg" → "kg"). See UnitIndex.
+    bool lenient = false;
+
+    /// Number format; DECIMAL tokens are always rewritten with '.' and no
+    /// grouping, so their value reads the same whatever the format
+    NumberFormat numbers;
 };
 
+/**
+ * @brief Value of a DECIMAL token
+ * @param text Token value ("1234.56")
+ * @return The value, or std::nullopt if it is not a number or does not
+ *         fit in a float
+ *
+ * Locale-independent (std::from_chars).
+ */
+std::optional<float> decimalValue(std::string_view text);
+
 /**
  * @class Lexer
  * @brief Lexical analyzer for conversion expressions
  *
  * The Lexer takes a string input like "convert 1.3 kg to lb" and breaks it
  * down into a sequence of tokens. It handles keywords, decimal numbers, unit
- * names (including Unicode characters), and whitespace.
+ * names (including Unicode characters), arithmetic operators and whitespace.
+ *
+ * The token list and the token strings are allocated from the memory
+ * resource given at construction, so that a bulk run can serve them from a
+ * monotonic arena released between batches.
+ *
+ * The input must be complete; use StreamLexer to lex input arriving in
+ * chunks. Both produce the same tokens.
  */
 class Lexer {
   public:
     /**
      * @brief Constructor for the Lexer
-     * @param text The input string to tokenize
+     * @param text The input string to tokenize (must outlive the Lexer)
+     * @param mr Memory resource for the tokens (default: global heap)
+     * @param options Lexing settings
      */
-    Lexer(std::string text) : text(std::move(text)), idx(0) {};
+    Lexer(std::string_view text,
+          std::pmr::memory_resource *mr = std::pmr::get_default_resource(),
+          LexerOptions options = {})
+        : text(text), mr(mr), options(options) {};
 
     /**
      * @brief Tokenizes the input string
      * @return A vector of tokens extracted from the input
      */
-    [[nodiscard]] std::vector<Token> lex();
+    [[nodiscard]] TokenList lex();
 
   private:
-    /**
-     * @brief Peeks at a character without consuming it
-     * @param offset Position ahead to peek (default 0 = current)
-     * @return Character at idx+offset, or '\0' if out of bounds
-     */
-    char pick(size_t offset = 0);
-
-    /**
-     * @brief Consumes and returns the current character
-     * @return Character at idx, or '\0' if out of bounds
-     */
-    char consume();
-
-    std::string text; ///< The input string being tokenized
-    size_t idx;       ///< Current position in the string
+    std::string_view text;         ///< The input string being tokenized
+    std::pmr::memory_resource *mr; ///< Allocator for the token stream
+    LexerOptions options;          ///< Lexing settings
 };
@@ -1,20 +1,54 @@
 #pragma once
 #include "Lexer.hpp"
+#include <memory_resource>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
+/**
+ * @struct ExprNode
+ * @brief One step of a conversion expression, in postfix order
+ *
+ * "3 kg + 500 g" is stored as: NUMBER 3, UNIT kg, NUMBER 500, UNIT g, ADD.
+ * NUMBER nodes appear in the same order as the numbers of the input.
+ */
+struct ExprNode {
+    enum class Kind {
+        NUMBER, ///< Pushes value (a scalar)
+        UNIT,   ///< Turns the scalar on top of the stack into a quantity
+        ADD,    ///< a + b
+        SUB,    ///< a - b
+        MUL,    ///< a * b
+        DIV,    ///< a / b
+        NEG     ///< -a
+    };
+
+    Kind kind;             ///< The operation
+    float value;           ///< Value of a NUMBER node
+    std::pmr::string unit; ///< Unit of a UNIT node
+};
+
 /**
  * @struct ConversionRequest
  * @brief Represents a parsed conversion request
  *
  * This structure holds the result of parsing a conversion expression:
- * the numeric value and the source/target units.
+ * the numeric value and the source/target units. For a compound
+ * expression ("5 ft 11 in", "3 kg + 500 g"), value and fromUnit hold its
+ * first quantity. A request can list several target units
+ * ("to m/s, mph, knot"); toUnit is the first one. The strings are
+ * allocated from the Parser's memory resource.
  */
 struct ConversionRequest {
-    float value;          ///< The numeric value to convert
-    std::string fromUnit; ///< The source unit
-    std::string toUnit;   ///< The target unit
+    float value;               ///< The numeric value to convert
+    std::pmr::string fromUnit; ///< The source unit
+    std::pmr::string toUnit;   ///< The (first) target unit
+    /// The whole source expression in postfix order ([NUMBER, UNIT] for a
+    /// plain request)
+    std::pmr::vector<ExprNode> expression;
+    /// All the target units, in order
+    std::pmr::vector<std::pmr::string> toUnits;
 };
 
 /**
@@ -34,30 +68,52 @@ class ParseError : public std::runtime_error {
  * @class Parser
  * @brief Syntax analyzer for conversion expressions
  *
- * Validates that tokens form: convert <DECIMAL> <UNIT> to <UNIT>
- * and extracts values into a ConversionRequest structure.
+ * Validates that tokens form a conversion request and extracts values
+ * into a ConversionRequest structure:
+ *
+ *   conversion → "convert" sum "to" UNIT ("," UNIT)*
+ *   sum        → product (("+" | "-") product)*
+ *   product    → unary (("*" | "/") unary)*
+ *   unary      → "-" unary | quantity
+ *   quantity   → primary (DECIMAL UNIT)*      juxtaposed: "5 ft 11 in"
+ *   primary    → DECIMAL UNIT? | "(" sum ")" UNIT?
+ *
+ * The expression must contain at least one unit. Dimensions are checked
+ * when the request is compiled (see ConversionPlan). Parentheses and unary
+ * minus nest at most ConversionPlan::MAX_DEPTH levels: the descent is
+ * recursive, and a deeper line would overflow the call stack.
+ *
+ * The Parser only borrows the token stream: it must outlive the Parser.
  */
 class Parser {
   public:
     /**
      * @brief Constructor for the Parser
-     * @param tokens The token stream from the Lexer
+     * @param tokens The token stream from the Lexer (not copied)
+     * @param mr Memory resource for the ConversionRequest strings
      */
-    explicit Parser(const std::vector<Token> &tokens);
+    explicit Parser(
+        const TokenList &tokens,
+        std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+    /// The token stream is borrowed, a temporary would dangle
+    explicit Parser(TokenList &&tokens,
+                    std::pmr::memory_resource *mr =
+                        std::pmr::get_default_resource()) = delete;
 
     /**
      * @brief Returns the current token without consuming it
      * @return The current token
      * @throw ParseError if at end of tokens
      */
-    Token peek();
+    const Token &peek();
 
     /**
      * @brief Returns and consumes the current token
      * @return The current token
      * @throw ParseError if at end of tokens
      */
-    Token consume();
+    const Token &consume();
 
     /**
      * @brief Checks if the token stream is exhausted
@@ -77,11 +133,48 @@ class Parser {
      * @brief Parses the token stream into a ConversionRequest
      * @return An optional ConversionRequest; empty if parsing fails
      *
-     * Expected format: convert <number> <unit> to <unit>
+     * Expected format: convert <expression> to <unit>[, <unit>...]
      */
     [[nodiscard]] std::optional<ConversionRequest> parse();
 
   private:
-    std::vector<Token> tokens; ///< The token stream
-    size_t idx;                ///< Current position in the token stream
+    /// Checks whether the current token is the given operator
+    bool isOperator(char op);
+
+    /// Appends a NUMBER node for the current DECIMAL token
+    void parseNumber();
+
+    void parseSum();      ///< sum → product (("+" | "-") product)*
+    void parseProduct();  ///< product → unary (("*" | "/") unary)*
+    void parseUnary();    ///< unary → "-" unary | quantity
+    void parseQuantity(); ///< quantity → primary (DECIMAL UNIT)*
+
+    /// primary → DECIMAL UNIT? | "(" sum ")" UNIT?
+    /// @return true if the primary ends with a unit
+    bool parsePrimary();
+
+    /// Appends an operation node to the expression
+    void emit(ExprNode::Kind kind);
+
+    /**
+     * @class Nesting
+     * @brief Counts one level of "(" or unary "-" for its lifetime
+     * @throw ParseError past ConversionPlan::MAX_DEPTH levels
+     */
+    class Nesting {
+      public:
+        explicit Nesting(Parser &parser);
+        ~Nesting() { depth--; }
+        Nesting(const Nesting &) = delete;
+        Nesting &operator=(const Nesting &) = delete;
+
+      private:
+        size_t &depth;
+    };
+
+    const TokenList &tokens;       ///< The borrowed token stream
+    size_t idx;                    ///< Current position in the token stream
+    size_t depth = 0;              ///< Open "(" and unary "-" levels
+    std::pmr::memory_resource *mr; ///< Allocator for the parsed request
+    std::pmr::vector<ExprNode> expression; ///< Expression being parsed
 };
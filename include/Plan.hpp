@@ -0,0 +1,266 @@
+#pragma once
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "Storage.hpp"
+#include "Unit.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class ConversionPlan
+ * @brief A conversion request compiled into a reusable program
+ *
+ * The plan is a small stack program over "slots": slot i is the i-th number
+ * of the request. Units are folded into constant factors at compile time,
+ * so evaluating a plan needs no lookup and no string comparison. The
+ * program computes the source value once, then every target unit is
+ * derived from it with its own coefficients:
+ *
+ *   "convert 3 kg + 500 g to lb, oz"
+ *   → PUSH 0, SCALE 1, PUSH 1, SCALE 0.001, ADD   (in kg)
+ *   → targets: base × 2.20462, base × 35.274
+ *
+ * A single quantity ("1.3 kg", "-5 °C") is not brought to the base unit:
+ * each target applies the pair coefficients of the registry
+ * (pairCoefficients()), so there is only one rounding and a conversion
+ * there and back returns within 1 ULP. Only linear units (UnitFactors) can
+ * be combined in an expression; its targets may be of any kind.
+ *
+ * Each target has its own ConversionKind and is computed by a loop
+ * specialized for that kind. Evaluation runs in double; results are
+ * rounded to float once.
+ *
+ * Every request with the same shape (same tokens, other numbers) shares
+ * the same plan, see PlanCache.
+ *
+ * Usage:
+ *   ConversionPlan plan = ConversionPlan::compile(request);
+ *   float slots[] = {3.0f, 500.0f};
+ *   float result = plan.evaluate(slots);
+ */
+class ConversionPlan {
+  public:
+    /// Maximum number of numbers in an expression
+    static constexpr size_t MAX_SLOTS = 32;
+
+    /// Maximum evaluation stack depth of an expression
+    static constexpr size_t MAX_DEPTH = 16;
+
+    /// Maximum number of target units
+    static constexpr size_t MAX_TARGETS = 32;
+
+    /**
+     * @brief Compiles a parsed request
+     * @param request The parsed request
+     * @return The plan
+     * @throw std::runtime_error if units are invalid or dimensions do not
+     *        match (sum of a mass and a length, non-linear unit in an
+     *        expression, target of another dimension...)
+     */
+    static ConversionPlan compile(const ConversionRequest &request);
+
+    /**
+     * @brief Evaluates the plan for one request, first target only
+     * @param slots The numbers of the request, in input order
+     * @return The value converted to the first target unit
+     */
+    [[nodiscard]] float evaluate(const float *slots) const;
+
+    /**
+     * @brief Evaluates the plan for one request, all targets
+     * @param slots The numbers of the request, in input order
+     * @param out One converted value per target unit
+     *
+     * The source is brought to the base unit once; the targets are then
+     * computed in a single branch-free loop the compiler vectorizes.
+     */
+    void evaluateAll(const float *slots, float *out) const;
+
+    /**
+     * @brief Evaluates the plan for many requests of the same shape
+     * @param slots Column-major numbers: number s of request i is
+     *        slots[s * count + i]
+     * @param count Number of requests
+     * @param out Target-major results: target t of request i is
+     *        out[t * count + i]
+     *
+     * Each operation runs over a whole block of requests, so the inner
+     * loops are branch-free and vectorized by the compiler.
+     *
+     * @throw std::runtime_error if a value is outside the domain of a
+     *        target (see inDomain()) or a divisor is zero, as for
+     *        evaluate() and evaluateAll()
+     */
+    void evaluateBatch(const float *slots, size_t count, float *out) const;
+
+    /// Number of slots (numbers) the plan reads
+    [[nodiscard]] size_t slotCount() const { return slots; }
+
+    /// Number of target units
+    [[nodiscard]] size_t targetCount() const { return toUnits.size(); }
+
+    /// Target unit i of the plan
+    [[nodiscard]] std::string_view targetUnit(size_t i = 0) const {
+        return toUnits[i];
+    }
+
+    /// Every target is an increasing affine map of the source value, so
+    /// the plan commutes with mean, min and max
+    [[nodiscard]] bool isAffine() const;
+
+  private:
+    /// One instruction of the plan
+    struct Op {
+        enum class Code {
+            PUSH,      ///< Push slot
+            SCALE,     ///< top *= factor
+            ADD,       ///< a + b
+            SUB,       ///< a - b
+            MUL,       ///< a * b
+            DIV,       ///< a / b
+            NEG        ///< -top
+        };
+
+        Code code;     ///< The operation
+        uint32_t slot; ///< Slot read by PUSH
+        double factor; ///< Operand of SCALE
+    };
+
+    /// Appends an instruction
+    void emit(Op::Code code, double factor = 0.0, uint32_t slot = 0);
+
+    /// Appends a target: result = base * scale + offset
+    void addTarget(std::string_view unit, Coefficients coefficients);
+
+    /// Compiles "<number> <unit>", optionally negated, with the pair
+    /// coefficients of the registry
+    static ConversionPlan compileSingle(const ConversionRequest &request);
+
+    /// Computes every target from the base values base[0..n)
+    void applyTargets(const double *base, size_t n, float *out,
+                      size_t stride) const;
+
+    std::vector<Op> ops; ///< The program, leaves the base value on the stack
+    size_t slots = 0;    ///< Number of slots read
+
+    /// Targets, as parallel arrays so the fan-out loop vectorizes
+    std::vector<std::string_view> toUnits;  ///< UnitSet keys
+    std::vector<ConversionKind> targetKind; ///< Kernel of each target
+    std::vector<double> targetScale;        ///< Multiplier of each target
+    std::vector<double> targetOffset;       ///< Added term of each target
+    bool linear = true; ///< Every target is LINEAR
+};
+
+/**
+ * @class PlanCache
+ * @brief Compiled plans indexed by request shape
+ *
+ * The shape of a request is its token stream with every number replaced by
+ * a placeholder: "convert 1.3 kg to lb" and "convert 7 kg to lb" share the
+ * shape "convert # kg to lb". A bulk run only parses and compiles the first
+ * request of each shape; the following ones are evaluated straight from
+ * their tokens.
+ */
+class PlanCache {
+  public:
+    /// Maximum number of cached shapes; the cache is emptied when full so
+    /// that inputs with unbounded shapes keep a flat footprint
+    static constexpr size_t MAX_PLANS = 4096;
+
+    /**
+     * @brief Looks up the plan for the shape of tokens
+     * @return The plan, or nullptr if this shape was never compiled
+     */
+    [[nodiscard]] const ConversionPlan *find(const TokenList &tokens);
+
+    /**
+     * @brief Stores the plan for the shape of tokens
+     * @return The cached plan
+     */
+    const ConversionPlan &insert(const TokenList &tokens,
+                                 ConversionPlan plan);
+
+    /// Number of cached shapes
+    [[nodiscard]] size_t size() const { return plans.size(); }
+
+  private:
+    /// Writes the shape of tokens into key
+    static void shapeKey(const TokenList &tokens, std::string &key);
+
+    std::string key; ///< Reused key buffer, avoids an allocation per lookup
+    std::unordered_map<std::string, ConversionPlan> plans;
+};
+
+/**
+ * @brief Converts values with the coefficients of one unit pair
+ * @param coefficients Map from the source to the target unit
+ * @param in Values in the source unit
+ * @param n Number of values
+ * @param out Values in the target unit; may be in itself (element i is
+ *        read before it is written), must not partially overlap it
+ *
+ * The same loops as the targets of a plan: one per ConversionKind,
+ * vectorized by the compiler, evaluated in double and rounded once, so a
+ * value gives the same float as a plan of the pair.
+ */
+void applyCoefficients(const Coefficients &coefficients, const float *in,
+                       size_t n, float *out);
+
+/**
+ * @brief Whether a conversion of this kind is defined at x
+ *
+ * A logarithm needs x > 0 and a reciprocal x != 0; the kernels would give
+ * -inf, NaN or inf there. The other kinds accept any value.
+ */
+[[nodiscard]] inline bool inDomain(ConversionKind kind, double x) {
+    switch (kind) {
+    case ConversionKind::LOGARITHMIC:
+        return !(x <= 0.0);
+    case ConversionKind::RECIPROCAL:
+        return x != 0.0;
+    default:
+        return true;
+    }
+}
+
+/// @brief Message of the error for a value outside the domain of a
+/// conversion of this kind to unit
+std::string domainError(ConversionKind kind, std::string_view unit);
+
+/**
+ * @brief Converts values with the coefficients of one unit pair into
+ *        16-bit storage codes
+ * @param format Encoding of the results
+ * @param step Value of one FIXED16 code (see fixedStep()), ignored by the
+ *        other formats
+ * @param out One code per value
+ * @param report Count, errors and overflows of these values are added to it
+ *
+ * The loops of applyCoefficients() with the encoding fused in: each result
+ * is computed in double and rounded once to its code, without a float
+ * array in between, then decoded again to measure its error.
+ */
+void applyCoefficients(const Coefficients &coefficients, const float *in,
+                       size_t n, StorageFormat format, double step,
+                       uint16_t *out, PrecisionReport &report);
+
+/**
+ * @brief Largest finite |result| of a unit pair over inputs in [low, high]
+ *
+ * Every ConversionKind is monotonic, so it is reached at low or high (a
+ * reciprocal over an interval around 0 has no finite bound: values near 0
+ * are left out). 0 if neither end gives a finite result.
+ */
+double resultBound(const Coefficients &coefficients, float low, float high);
+
+/**
+ * @brief Reads the numbers of a request into slots
+ * @param tokens The token stream
+ * @param slots Output, at least ConversionPlan::MAX_SLOTS floats
+ * @return Number of slots written
+ * @throw std::runtime_error if there are more than MAX_SLOTS numbers
+ */
+size_t readSlots(const TokenList &tokens, float *slots);
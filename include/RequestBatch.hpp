@@ -0,0 +1,149 @@
+#pragma once
+#include "Lexer.hpp"
+#include "Storage.hpp"
+#include "Unit.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct ColumnReport
+ * @brief Error of the 16-bit codes of one target unit of a batch
+ */
+struct ColumnReport {
+    UnitId unit;               ///< Target unit of the column
+    PrecisionReport precision; ///< Step (FIXED16), errors and overflows
+};
+
+/**
+ * @class RequestBatch
+ * @brief Plain conversion requests of any units, stored as parallel arrays
+ *
+ * A plain request ("convert 3.5 km to mi": one number, one source unit,
+ * one target unit) is a row of three columns: its value, its source UnitId
+ * and its target UnitId. Rows of a mixed-unit stream are appended as they
+ * are lexed, without any string or allocation per row.
+ *
+ * convert() groups the rows by unit pair with a counting sort: each
+ * pair met is given a group as rows are appended (a table indexed by
+ * source and target UnitId, so a known pair costs one load), and the rows
+ * of each group are counted; one pass then copies every value into the
+ * run of its group. Each run goes through one call of the kernel of its pair
+ * (applyCoefficients()), a branch-free loop over contiguous values, and
+ * the results are put back in row order. Only the pairs present in the
+ * batch are visited, so a small batch does not pay for the size of the
+ * registry.
+ *
+ * Usage:
+ *   RequestBatch batch;
+ *   batch.push(tokens);                    // from a lexed line
+ *   batch.push(3.5f, *unitId("km"), *unitId("mi"));
+ *   std::vector<float> results(batch.size());
+ *   batch.convert(results.data());
+ *
+ *   std::vector<uint16_t> codes(batch.size());   // half the size
+ *   std::vector<ColumnReport> report;
+ *   batch.convert(StorageFormat::FLOAT16, codes.data(), report);
+ */
+class RequestBatch {
+  public:
+    /**
+     * @brief Appends a request
+     * @return false, and nothing appended, if the units are of different
+     *         dimensions or the value is outside the domain of the pair
+     *         (see inDomain())
+     */
+    [[nodiscard]] bool push(float value, UnitId from, UnitId to);
+
+    /**
+     * @brief Appends a lexed request if it is plain
+     * @param tokens "convert" DECIMAL UNIT "to" UNIT
+     * @return false, and nothing appended, for any other request (an
+     *         expression, several targets, incompatible units, a value
+     *         outside the domain of the pair...)
+     */
+    [[nodiscard]] bool push(const TokenList &tokens);
+
+    /**
+     * @brief Converts every row
+     * @param out One value per row, in the target unit, in row order
+     */
+    void convert(float *out);
+
+    /**
+     * @brief Converts every row into 16-bit storage codes
+     * @param format Encoding of the results
+     * @param out One code per row, in row order
+     * @param report Receives one entry per target unit, by UnitId
+     *
+     * Encoding is fused into the kernel of each pair (see
+     * applyCoefficients()). For FIXED16, the step of each target unit is
+     * chosen from the range of its results: the extremes of the inputs of
+     * each pair are mapped through its coefficients first, and the step is
+     * the smallest power of two that holds them all (fixedStep()).
+     */
+    void convert(StorageFormat format, uint16_t *out,
+                 std::vector<ColumnReport> &report);
+
+    /**
+     * @brief Converts every row through 16-bit storage, as a reader of the
+     *        stored codes would get them back
+     * @param format Encoding of the results
+     * @param out One value per row: its code, decoded (exact in a float)
+     * @param reports Errors per target unit, indexed by UnitId (resized to
+     *        UnitSet.size()), merged with those of this batch; step keeps
+     *        the largest FIXED16 step
+     */
+    void convertStored(StorageFormat format, float *out,
+                       std::vector<PrecisionReport> &reports);
+
+    /// Removes every row; the storage is kept for the next rows
+    void clear();
+
+    /// Number of rows
+    [[nodiscard]] size_t size() const { return values.size(); }
+
+    /// Whether the batch has no row
+    [[nodiscard]] bool empty() const { return values.empty(); }
+
+    /// Value of each row, in its source unit
+    [[nodiscard]] const float *valueColumn() const { return values.data(); }
+
+    /// Source unit of each row
+    [[nodiscard]] const UnitId *fromColumn() const { return fromIds.data(); }
+
+    /// Target unit of each row
+    [[nodiscard]] const UnitId *toColumn() const { return toIds.data(); }
+
+  private:
+    /// Copies the values into the runs of their groups (grouped, order)
+    void groupRows();
+
+    std::vector<float> values;   ///< Value of each row
+    std::vector<UnitId> fromIds; ///< Source unit of each row
+    std::vector<UnitId> toIds;   ///< Target unit of each row
+    std::vector<uint32_t> groups; ///< Group of each row, the sort key
+
+    /// Marks a pair without group in groupOf
+    static constexpr uint32_t NO_GROUP = UINT32_MAX;
+
+    std::vector<PairId> pairs;  ///< Pair of each group
+    std::vector<uint32_t> rows; ///< Number of rows of each group
+    std::vector<uint32_t> cells; ///< Entry of groupOf of each group
+    /// Group of each (from, to) at from * UnitSet.size() + to, NO_GROUP
+    /// for the pairs absent from the batch
+    std::vector<uint32_t> groupOf =
+        std::vector<uint32_t>(UnitSet.size() * UnitSet.size(), NO_GROUP);
+
+    // Tampons de convert(), gardés d'un appel à l'autre
+    std::vector<uint32_t> next;   ///< Next slot of the run of each group
+    std::vector<uint32_t> order;  ///< Row of each grouped value
+    std::vector<float> grouped;   ///< Values grouped by pair
+    std::vector<float> converted; ///< Results, grouped by pair
+    std::vector<uint16_t> codes;  ///< Storage codes, grouped by pair
+    /// Codes and report of convertStored(), in row order
+    std::vector<uint16_t> stored;
+    std::vector<ColumnReport> columns;
+    /// Entry of report of each target unit during a convert(), -1 if none
+    std::vector<int32_t> columnOf = std::vector<int32_t>(UnitSet.size(), -1);
+};
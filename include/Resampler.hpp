@@ -0,0 +1,122 @@
+#pragma once
+#include "Plan.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @struct Window
+ * @brief Aggregates of the samples of one resampling window, converted
+ */
+struct Window {
+    int64_t start; ///< First timestamp of the window
+    size_t count;  ///< Number of samples
+    float mean;    ///< Mean value, in the target unit
+    float min;     ///< Smallest value, in the target unit
+    float max;     ///< Largest value, in the target unit
+};
+
+/**
+ * @class Resampler
+ * @brief Unit conversion and downsampling of a time series in one pass
+ *
+ * Samples (timestamp, value) are grouped into fixed windows
+ * [k * length, (k + 1) * length) and reduced to their mean, min and max.
+ * A linear or affine conversion (a factor, plus an offset for
+ * temperatures) is increasing, so it commutes with these aggregates: the
+ * samples are reduced in the source unit and only the three aggregates of
+ * each window are converted, through the same ConversionPlan as a
+ * "convert" request. Other kinds (mpg, dBm...) do not commute with the
+ * mean; their samples are converted in batches before the reduction.
+ *
+ * The samples of a window are contiguous, so each window is reduced by a
+ * branch-free loop over independent lanes that the compiler vectorizes.
+ *
+ * Usage:
+ *   Resampler resampler("mph", "m/s", 60);
+ *   std::vector<Window> windows;
+ *   resampler.check(timestamp, value);   // per sample, before buffering
+ *   resampler.push(timestamps, values, count, windows);
+ *   resampler.finish(windows);
+ */
+class Resampler {
+  public:
+    /**
+     * @brief Constructor
+     * @param fromUnit Unit of the samples
+     * @param toUnit Unit of the aggregates
+     * @param length Window length, in timestamp units
+     * @throw std::runtime_error if the units are invalid or incompatible,
+     *        or the length is not positive
+     */
+    Resampler(std::string_view fromUnit, std::string_view toUnit,
+              int64_t length);
+
+    /**
+     * @brief Validates the next sample, in push order
+     * @throw std::runtime_error if the timestamp goes back before the
+     *        window of the last sample accepted, or the value is outside
+     *        the domain of the conversion (see inDomain()); the sample is
+     *        not accepted and must be left out
+     *
+     * push() does not throw on samples that were all accepted.
+     */
+    void check(int64_t timestamp, float value);
+
+    /**
+     * @brief Adds samples
+     * @param timestamps Timestamps; windows must come in increasing order,
+     *        samples of one window may be in any order
+     * @param values Sample values, in the source unit
+     * @param count Number of samples
+     * @param out Receives the windows completed by these samples
+     * @throw std::runtime_error if a timestamp goes back before the current
+     *        window, or a value is outside the domain of the conversion
+     */
+    void push(const int64_t *timestamps, const float *values, size_t count,
+              std::vector<Window> &out);
+
+    /**
+     * @brief Ends the series
+     * @param out Receives the last window, if any
+     */
+    void finish(std::vector<Window> &out);
+
+    /// Unit of the aggregates
+    [[nodiscard]] std::string_view targetUnit() const {
+        return plan.targetUnit();
+    }
+
+  private:
+    /// Window being filled, in the source unit (target unit if
+    /// convertFirst)
+    struct Partial {
+        int64_t start;
+        size_t count;
+        double sum;
+        float min;
+        float max;
+    };
+
+    /// Start of the window containing timestamp
+    [[nodiscard]] int64_t windowStart(int64_t timestamp) const;
+
+    /// Adds values[0..count) to the current window
+    void reduce(const float *values, size_t count);
+
+    /// Converts the pending windows and appends them to out
+    void emit(std::vector<Window> &out);
+
+    ConversionPlan plan;
+    int64_t length;
+    ConversionKind kind;         ///< Kernel of the conversion
+    bool convertFirst;           ///< Non-affine conversion: samples first
+    bool checked = false;        ///< A sample was accepted by check()
+    int64_t checkedStart = 0;    ///< Window of the last sample accepted
+    bool open = false;           ///< A window is being filled
+    Partial current{};           ///< The window being filled
+    std::vector<Partial> closed; ///< Completed, not yet converted
+    std::vector<float> scratch;  ///< Aggregates laid out for evaluateBatch
+    std::vector<float> samples;  ///< Converted samples (convertFirst)
+};
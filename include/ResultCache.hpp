@@ -0,0 +1,121 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class ResultCache
+ * @brief Persistent content-addressed cache of converted chunks
+ *
+ * Bulk mode splits its input into chunks of lines. The converted output of
+ * a chunk is stored under the hash of the chunk text, so a later run over
+ * the same input copies the output of every unchanged chunk instead of
+ * lexing, parsing and converting its lines again.
+ *
+ * The cache file is mapped read-only with mmap; lookups are a binary
+ * search over its sorted entry table and hits point straight into the
+ * mapping. New results are kept in memory and written by save() to a new
+ * file which atomically replaces the old one.
+ *
+ * The file records the registry version it was built with: a file written
+ * with other units, aliases or factors (see registryVersion()) is ignored.
+ *
+ * File layout (native endianness):
+ *   Header  { magic, version, count }
+ *   Entry   { key, offset, length } × count, sorted by key
+ *   bytes   outputs, addressed by offset from the end of the entry table
+ *
+ * Usage:
+ *   ResultCache cache("results.cache", registryVersion());
+ *   uint64_t key = ResultCache::chunkKey(chunk);
+ *   if (auto output = cache.find(key)) { ... } else { cache.insert(key, o); }
+ *   cache.save();
+ */
+class ResultCache {
+  public:
+    /// Maximum number of entries; beyond it, save() only keeps the entries
+    /// used or added by the current run
+    static constexpr size_t MAX_ENTRIES = 1 << 20;
+
+    /**
+     * @brief Opens a cache file
+     * @param path Cache file; missing, unreadable or corrupt files give an
+     *        empty cache
+     * @param version Registry version the results depend on
+     */
+    ResultCache(std::string path, uint64_t version);
+    ~ResultCache();
+
+    ResultCache(const ResultCache &) = delete;
+    ResultCache &operator=(const ResultCache &) = delete;
+
+    /**
+     * @brief Key of a chunk
+     * @param chunk The chunk text
+     * @param seed Settings the output depends on (e.g. lenient mode)
+     */
+    static uint64_t chunkKey(std::string_view chunk, uint64_t seed = 0);
+
+    /**
+     * @brief Looks up the output of a chunk
+     * @return The cached output (valid until save() or destruction), or
+     *         nothing on a miss
+     */
+    [[nodiscard]] std::optional<std::string_view> find(uint64_t key);
+
+    /**
+     * @brief Records the output of a chunk, written by the next save()
+     */
+    void insert(uint64_t key, std::string output);
+
+    /**
+     * @brief Writes the cache file if new results were inserted
+     * @throw std::runtime_error if the file cannot be written
+     */
+    void save();
+
+    /// Number of successful lookups
+    [[nodiscard]] size_t hits() const { return hitCount; }
+
+    /// Number of failed lookups
+    [[nodiscard]] size_t misses() const { return missCount; }
+
+  private:
+    /// Fixed-size file header
+    struct Header {
+        char magic[8];    ///< "CNVCACHE"
+        uint64_t version; ///< Registry version
+        uint64_t count;   ///< Number of entries
+    };
+
+    /// One cached chunk
+    struct Entry {
+        uint64_t key;    ///< Chunk key
+        uint64_t offset; ///< Output position in the data area
+        uint64_t length; ///< Output length
+    };
+
+    /// Maps the file and validates it; leaves the cache empty on failure
+    void load();
+
+    /// Unmaps the file
+    void unmap();
+
+    std::string path;
+    uint64_t version;
+
+    void *mapping = nullptr;         ///< Mapped file, or nullptr
+    size_t mappingSize = 0;          ///< Size of the mapping
+    const Entry *entries = nullptr;  ///< Sorted entry table of the file
+    size_t entryCount = 0;           ///< Number of entries in the file
+    const char *data = nullptr;      ///< Data area of the file
+    std::vector<bool> used;          ///< Entries hit during this run
+
+    std::unordered_map<uint64_t, std::string> added; ///< New results
+    size_t hitCount = 0;
+    size_t missCount = 0;
+};
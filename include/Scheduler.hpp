@@ -0,0 +1,162 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Scheduler
+ * @brief Work-stealing pool of worker threads for bulk conversions
+ *
+ * Each worker owns a double-ended queue of tasks. A task spawned by a
+ * worker goes to the back of its own queue, and the worker takes its next
+ * task from the back too: the most recent, smallest piece of work, whose
+ * data is still in its cache. A worker whose queue is empty steals from
+ * the front of another queue, taking the oldest and largest piece of work
+ * there. Tasks spawned from outside the pool are dealt to the queues in
+ * turn.
+ *
+ * parallelFor() splits a range in halves down to a grain: the right half
+ * is spawned, the left one processed on. A large job is thus spread over
+ * the idle workers in a logarithmic number of steals, instead of keeping
+ * one core busy while the others wait behind a fixed partition.
+ *
+ * Each queue is guarded by its own mutex; a task being tens of
+ * microseconds of work, the lock is negligible and never contended but by
+ * a thief.
+ *
+ * Usage:
+ *   Scheduler scheduler(4);
+ *   scheduler.parallelFor(0, n, 1024, [&](size_t begin, size_t end) {
+ *       ...
+ *   });
+ *   scheduler.wait();
+ */
+class Scheduler {
+  public:
+    /// A unit of work
+    using Task = std::function<void()>;
+
+    /// Counters of one worker, since the pool started
+    struct WorkerStats {
+        uint64_t tasks = 0;  ///< Tasks run
+        uint64_t steals = 0; ///< Tasks taken from another worker's queue
+        double busy = 0.0;   ///< Seconds spent running tasks
+    };
+
+    /**
+     * @brief Starts the workers
+     * @param workers Number of threads, 0 for one per hardware thread
+     */
+    explicit Scheduler(unsigned workers = 0);
+
+    /// Runs the remaining tasks, then stops and joins the workers
+    ~Scheduler();
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    /**
+     * @brief Queues a task
+     *
+     * From a task, the new task goes to the queue of the current worker;
+     * from another thread, to the queues in turn.
+     */
+    void spawn(Task task);
+
+    /**
+     * @brief Runs body over [begin, end) split recursively into pieces of
+     *        at most grain elements
+     * @param body Called as body(first, last) once per piece, from any
+     *        worker; copied into every spawned task
+     *
+     * Returns at once; wait() for the pieces to be processed.
+     */
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, Body body);
+
+    /**
+     * @brief Waits until every spawned task has run
+     * @throw The first exception thrown by a task since the last wait()
+     *
+     * Not to be called from a task.
+     */
+    void wait();
+
+    /// Number of workers
+    [[nodiscard]] unsigned size() const {
+        return static_cast<unsigned>(workers.size());
+    }
+
+    /// Index of the worker running the calling task, or -1 outside the pool
+    [[nodiscard]] static int currentWorker();
+
+    /// Counters of each worker; exact once wait() returned
+    [[nodiscard]] std::vector<WorkerStats> stats() const;
+
+    /// Seconds since the pool started, to turn busy time into utilization
+    [[nodiscard]] double elapsed() const;
+
+  private:
+    /// Queue and counters of a worker, on their own cache lines
+    struct alignas(64) Worker {
+        std::mutex lock;        ///< Guards tasks
+        std::deque<Task> tasks; ///< Back: owner end, front: thieves' end
+        WorkerStats stats;      ///< Written by the worker only
+        unsigned victim = 0;    ///< Next queue to steal from
+        std::thread thread;
+    };
+
+    /// Worker loop
+    void run(unsigned index);
+
+    /// Takes a task from the queue of worker index, or steals one
+    bool take(unsigned index, Task &task);
+
+    /// Halves [begin, end) until grain, spawning the right halves
+    template <typename Body>
+    void split(size_t begin, size_t end, size_t grain, const Body &body);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> queued{0};  ///< Tasks in the queues
+    std::atomic<size_t> pending{0}; ///< Tasks spawned and not yet finished
+    std::atomic<unsigned> next{0};  ///< Queue of the next outside spawn
+    std::chrono::steady_clock::time_point started;
+
+    std::mutex sleepLock;          ///< Guards the fields below
+    std::condition_variable wake;  ///< Signals queued tasks or stopping
+    std::condition_variable done;  ///< Signals pending reaching 0
+    bool stopping = false;         ///< Set by the destructor
+    std::exception_ptr failure;    ///< First exception of a task
+};
+
+template <typename Body>
+void Scheduler::parallelFor(size_t begin, size_t end, size_t grain,
+                            Body body) {
+    if (begin >= end) {
+        return;
+    }
+    grain = grain == 0 ? 1 : grain;
+    spawn([this, begin, end, grain, body] { split(begin, end, grain, body); });
+}
+
+template <typename Body>
+void Scheduler::split(size_t begin, size_t end, size_t grain,
+                      const Body &body) {
+    while (end - begin > grain) {
+        size_t middle = begin + (end - begin) / 2;
+        spawn([this, middle, end, grain, body] {
+            split(middle, end, grain, body);
+        });
+        end = middle;
+    }
+    body(begin, end);
+}
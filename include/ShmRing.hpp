@@ -0,0 +1,197 @@
+#pragma once
+#include "RequestBatch.hpp"
+#include "Unit.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @struct SampleRecord
+ * @brief One binary conversion request or result of a ShmRing
+ *
+ * A request is a value and its unit pair; the converter publishes the
+ * same record with value in the target unit. A pair of different
+ * dimensions, an unknown id or a value outside the domain of the pair
+ * (see inDomain()) comes back with from = INVALID_UNIT.
+ */
+struct SampleRecord {
+    float value; ///< Value, in from (request) or in to (result)
+    UnitId from; ///< Source unit
+    UnitId to;   ///< Target unit
+};
+
+/// Source unit of a result whose request could not be converted
+constexpr UnitId INVALID_UNIT = UINT16_MAX;
+
+/**
+ * @class ShmRing
+ * @brief Bounded lock-free queue of SampleRecord in POSIX shared memory
+ *
+ * A ring lets a process on the same host hand samples to the converter
+ * without system calls, text or Lexer: producers and the consumer map the
+ * same shm_open() object and exchange records through atomics only.
+ *
+ * Any number of producers, one consumer (MPSC; a single producer is the
+ * SPSC case). Each slot carries a sequence number (bounded queue of
+ * D. Vyukov): a producer claims the next position with a compare-and-swap
+ * on the tail, writes its record and publishes it by storing the slot
+ * sequence; the consumer reads the slots in order while their sequence
+ * says they are published, then hands them back to the producers for the
+ * next lap. A producer that stalls between its claim and its publication
+ * only delays the records after it.
+ *
+ * Tail and head are on their own cache lines, so producers and consumer
+ * do not invalidate each other's line on every record.
+ *
+ * Mapping layout (native endianness, the processes share the host):
+ *   Header  { magic, version, capacity, closed | tail | head }
+ *   Slot    { sequence, SampleRecord } × capacity
+ *
+ * Usage:
+ *   ShmRing ring = ShmRing::create("/samples", 1 << 16);   // or attach()
+ *   ring.push(SampleRecord{3.5f, km, mi});                 // producer
+ *   size_t n = ring.pop(records, 256);                     // consumer
+ *   ring.close();                                          // no more input
+ */
+class ShmRing {
+  public:
+    /**
+     * @brief Creates a ring and maps it
+     * @param name Shared-memory object name ("/samples"), must not exist
+     * @param capacity Number of slots, a power of two
+     * @throw std::runtime_error if the object cannot be created or mapped
+     */
+    static ShmRing create(const std::string &name, size_t capacity);
+
+    /**
+     * @brief Maps an existing ring
+     * @throw std::runtime_error if the object is missing or is not a ring
+     *        of this layout version
+     */
+    static ShmRing attach(const std::string &name);
+
+    /// Removes the shared-memory object; mapped rings stay valid until
+    /// unmapped
+    static void remove(const std::string &name);
+
+    ~ShmRing();
+    ShmRing(ShmRing &&other) noexcept;
+    ShmRing &operator=(ShmRing &&other) noexcept;
+    ShmRing(const ShmRing &) = delete;
+    ShmRing &operator=(const ShmRing &) = delete;
+
+    /**
+     * @brief Publishes a record (any producer)
+     * @return false, and nothing published, if the ring is full
+     */
+    [[nodiscard]] bool push(const SampleRecord &record);
+
+    /**
+     * @brief Takes the published records in order (the consumer only)
+     * @param out Receives up to max records
+     * @return Number of records taken, 0 if none is published yet
+     */
+    size_t pop(SampleRecord *out, size_t max);
+
+    /// Number of records pushed and not yet popped, counting those whose
+    /// producer is still writing them
+    [[nodiscard]] size_t readable() const;
+
+    /**
+     * @brief Number of records a single producer can push without failing
+     *
+     * Exact for the only producer of the ring, a lower bound otherwise.
+     */
+    [[nodiscard]] size_t writable() const;
+
+    /// Marks the end of the input; every producer must have made its last
+    /// push
+    void close();
+
+    /// The ring was closed; records published before may still be pending
+    [[nodiscard]] bool closed() const;
+
+    /// Number of slots
+    [[nodiscard]] size_t capacity() const { return mask + 1; }
+
+  private:
+    struct Header;
+    struct Slot;
+
+    ShmRing(void *mapping, size_t bytes);
+
+    void *mapping = nullptr; ///< The whole shared-memory object
+    size_t bytes = 0;        ///< Size of the mapping
+    Header *header = nullptr;
+    Slot *slots = nullptr;
+    uint64_t mask = 0; ///< capacity - 1
+};
+
+/**
+ * @class RingConverter
+ * @brief Converts the records of an input ring into an output ring
+ *
+ * Records are taken a block at a time, converted by a RequestBatch
+ * (grouped by unit pair, one kernel call per pair) and published in the
+ * same order to the output ring, of which the converter must be the only
+ * producer. A block is never larger than the free space of the output
+ * ring, so no converted record is ever dropped or held back.
+ *
+ * With a storage format, each result is rounded to its 16-bit code and
+ * published decoded, the value a reader of the stored code gets; the
+ * errors are accumulated per target unit (reports()).
+ *
+ * Usage:
+ *   RingConverter converter(input, output);
+ *   converter.run();   // until the input is closed and drained
+ */
+class RingConverter {
+  public:
+    /// Records converted per step at most
+    static constexpr size_t BLOCK = 1024;
+
+    /**
+     * @brief Constructor
+     * @param in Ring of requests
+     * @param out Ring of results, of which the converter is the only
+     *        producer
+     * @param store 16-bit format the results are rounded to, if any
+     */
+    RingConverter(ShmRing &in, ShmRing &out,
+                  std::optional<StorageFormat> store = std::nullopt)
+        : in(in), out(out), store(store) {}
+
+    /**
+     * @brief Converts the records published so far, up to BLOCK
+     * @return Number of records converted, 0 if none was ready (or the
+     *         output ring is full)
+     */
+    size_t step();
+
+    /**
+     * @brief Converts until the input ring is closed and drained, then
+     *        closes the output ring
+     * @return Number of records converted
+     *
+     * Waits for input by spinning, then yielding the processor: no system
+     * call while records keep coming.
+     */
+    uint64_t run();
+
+    /// Errors of the storage format per target unit, indexed by UnitId
+    /// (empty without a format)
+    [[nodiscard]] const std::vector<PrecisionReport> &reports() const {
+        return storeReports;
+    }
+
+  private:
+    ShmRing &in;
+    ShmRing &out;
+    std::optional<StorageFormat> store; ///< 16-bit rounding of the results
+    std::vector<PrecisionReport> storeReports; ///< See reports()
+    RequestBatch batch;
+    std::vector<SampleRecord> records; ///< Records of the current step
+    std::vector<float> results;        ///< Converted values of the batch
+};
@@ -0,0 +1,184 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+/**
+ * @enum StorageFormat
+ * @brief 16-bit encoding of converted values, for storage
+ *
+ * Every format stores a value in one uint16_t code, half the size of a
+ * float and a quarter of a double. Values are rounded once, to nearest
+ * (ties to even), from the double result of the conversion.
+ */
+enum class StorageFormat {
+    FLOAT16,  ///< IEEE binary16: 11 significant bits, |x| ≤ 65504
+    BFLOAT16, ///< float exponent range, 8 significant bits
+    FIXED16   ///< int16 code × step, step a power of two per column
+};
+
+/// Code of FIXED16 for a value that is not a number
+constexpr uint16_t FIXED16_NAN = 0x8000;
+
+/// Largest code magnitude of FIXED16
+constexpr int32_t FIXED16_MAX = 32767;
+
+/**
+ * @brief Rounds a double to a 16-bit binary floating-point format
+ * @tparam EXP Exponent bits (5: binary16, 8: bfloat16)
+ * @tparam MAN Stored significand bits (10: binary16, 7: bfloat16)
+ *
+ * Works on the bits of the double, so there is a single rounding (a
+ * conversion through float would round twice). Overflow gives ±inf, NaN
+ * stays a quiet NaN, tiny values become subnormals or ±0.
+ */
+template <int EXP, int MAN> inline uint16_t roundBinary16(double value) {
+    static_assert(1 + EXP + MAN == 16, "Format de 16 bits attendu");
+    constexpr int BIAS = (1 << (EXP - 1)) - 1;
+    constexpr int SHIFT = 52 - MAN;
+    constexpr uint64_t INFINITY_CODE = uint64_t((1 << EXP) - 1) << MAN;
+
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    auto sign = static_cast<uint16_t>((bits >> 48) & 0x8000);
+    bits &= ~(uint64_t(1) << 63);
+    if (bits > uint64_t(0x7FF) << 52) {
+        return sign | INFINITY_CODE | (1 << (MAN - 1)); // NaN
+    }
+
+    // Exposant biaisé du format cible
+    int64_t exponent = static_cast<int64_t>(bits >> 52) - 1023 + BIAS;
+    uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+    if (exponent >= 1) {
+        // Normal: arrondi de la mantisse, la retenue passe dans l'exposant
+        uint64_t v = (static_cast<uint64_t>(exponent) << 52) | mantissa;
+        v += (uint64_t(1) << (SHIFT - 1)) - 1 + ((v >> SHIFT) & 1);
+        uint64_t code = v >> SHIFT;
+        return sign | static_cast<uint16_t>(
+                          code < INFINITY_CODE ? code : INFINITY_CODE);
+    }
+    if ((bits >> 52) == 0) {
+        return sign; // zéro ou sous-normal du double
+    }
+
+    // Sous-normal du format cible: unité 2^(1 - BIAS - MAN)
+    int64_t shift = SHIFT + 1 - exponent;
+    if (shift > 54) {
+        return sign;
+    }
+    mantissa |= uint64_t(1) << 52;
+    uint64_t code = mantissa >> shift;
+    uint64_t rest = mantissa & ((uint64_t(1) << shift) - 1);
+    uint64_t half = uint64_t(1) << (shift - 1);
+    code += rest > half || (rest == half && (code & 1) != 0);
+    return sign | static_cast<uint16_t>(code);
+}
+
+/**
+ * @brief Value of a 16-bit binary floating-point code
+ * @tparam EXP, MAN As roundBinary16()
+ */
+template <int EXP, int MAN> inline double expandBinary16(uint16_t code) {
+    constexpr int BIAS = (1 << (EXP - 1)) - 1;
+    uint64_t exponent = (code >> MAN) & ((1 << EXP) - 1);
+    uint64_t mantissa = code & ((1 << MAN) - 1);
+    uint64_t bits;
+    if (exponent == (1 << EXP) - 1) {
+        bits = (uint64_t(0x7FF) << 52) | (mantissa << (52 - MAN));
+    } else if (exponent == 0) {
+        // Sous-normal: mantisse × 2^(1 - BIAS - MAN), exact en double
+        double unit;
+        uint64_t unitBits = uint64_t(1023 + 1 - BIAS - MAN) << 52;
+        std::memcpy(&unit, &unitBits, sizeof unit);
+        double magnitude = static_cast<double>(mantissa) * unit;
+        std::memcpy(&bits, &magnitude, sizeof bits);
+    } else {
+        // Normal: l'exposant rebiaisé, la mantisse décalée
+        bits = ((exponent - BIAS + 1023) << 52) | (mantissa << (52 - MAN));
+    }
+    bits |= uint64_t(code & 0x8000) << 48;
+    double value;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+/**
+ * @brief Encodes a value
+ * @param inverseStep 1 / step of FIXED16, ignored by the other formats
+ *
+ * FIXED16 saturates at ±FIXED16_MAX codes; NaN gives FIXED16_NAN.
+ */
+template <StorageFormat format>
+inline uint16_t encodeStorage(double value, double inverseStep) {
+    if constexpr (format == StorageFormat::FLOAT16) {
+        return roundBinary16<5, 10>(value);
+    } else if constexpr (format == StorageFormat::BFLOAT16) {
+        return roundBinary16<8, 7>(value);
+    } else {
+        double q = std::nearbyint(value * inverseStep);
+        q = q > FIXED16_MAX ? FIXED16_MAX : q;
+        q = q < -FIXED16_MAX ? -FIXED16_MAX : q;
+        return q == q ? static_cast<uint16_t>(static_cast<int16_t>(q))
+                      : FIXED16_NAN;
+    }
+}
+
+/// @brief Value of a code
+/// @param step Value of one FIXED16 code, ignored by the other formats
+template <StorageFormat format>
+inline double decodeStorage(uint16_t code, double step) {
+    if constexpr (format == StorageFormat::FLOAT16) {
+        return expandBinary16<5, 10>(code);
+    } else if constexpr (format == StorageFormat::BFLOAT16) {
+        return expandBinary16<8, 7>(code);
+    } else {
+        return code == FIXED16_NAN ? NAN : static_cast<int16_t>(code) * step;
+    }
+}
+
+/// @brief Value of a code, for a format known at run time
+double decodeStorage(StorageFormat format, uint16_t code, double step);
+
+/// @brief Name of a format: "float16", "bfloat16" or "fixed16"
+const char *storageName(StorageFormat format);
+
+/// @brief Format of a name given by storageName(), nothing if unknown
+std::optional<StorageFormat> storageFormat(std::string_view name);
+
+/**
+ * @brief Step of a FIXED16 column
+ * @param bound Largest magnitude the column has to hold
+ * @return The smallest power of two step such that bound fits in
+ *         FIXED16_MAX codes (1 if bound is 0 or not finite)
+ *
+ * A power of two is exact in any binary format, so the step can be stored
+ * as its exponent and decoding is one multiplication without rounding.
+ */
+double fixedStep(double bound);
+
+/**
+ * @struct PrecisionReport
+ * @brief Error of the codes of a column against the double results
+ *
+ * Results that are not finite (log of a negative value...) are counted
+ * but left out of the errors.
+ */
+struct PrecisionReport {
+    size_t count = 0;         ///< Values encoded
+    double step = 0.0;        ///< Step of FIXED16, 0 for the other formats
+    double maxAbsError = 0.0; ///< Largest |decoded - exact|
+    double maxRelError = 0.0; ///< Largest |decoded - exact| / |exact|
+    double sumSquares = 0.0;  ///< Sum of the squared errors
+    size_t overflows = 0;     ///< Finite values saturated or sent to ±inf
+
+    /// Root mean square of the errors
+    [[nodiscard]] double rmsError() const {
+        return count == 0 ? 0.0 : std::sqrt(sumSquares / count);
+    }
+
+    /// Adds the values of another report of the same column
+    void merge(const PrecisionReport &other);
+};
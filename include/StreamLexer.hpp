@@ -0,0 +1,119 @@
+#pragma once
+#include "Lexer.hpp"
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+/**
+ * @class StreamLexer
+ * @brief Resumable lexer over input split into arbitrary byte chunks
+ *
+ * The input is fed as it is read (socket, file blocks): a chunk may end in
+ * the middle of a line, of a number or of a multi-byte UTF-8 unit such as
+ * "μm" or "m²". Tokens are emitted as soon as they are complete; only the
+ * bytes of the token in progress are kept across chunks, never whole
+ * lines. Tokens are those of Lexer, which is a StreamLexer fed with its
+ * whole input.
+ *
+ * Numbers are read in the format of LexerOptions::numbers by the scanner
+ * itself and emitted rewritten with '.' and without grouping.
+ *
+ * Bytes are classified with the locale-independent ByteClass table, and
+ * runs of digits, letters and spaces are skipped with span (SSE2). A unit
+ * is a word of letters, digits, '/' and UTF-8 characters ("m³/s",
+ * "L/100km"); every UTF-8 sequence is validated, byte by byte (only the
+ * non-ASCII bytes, see SpanScanner), and a word holding an invalid one is
+ * UNKNOWN. Look-alike characters are folded before the
+ * lookup: 'µ' (micro sign) is read as 'μ', 'º' and '˚' as '°', "℃" as
+ * "°C". A word that is not a unit but has a digit ends before the digit
+ * ("5ft11in" is 5 ft 11 in).
+ *
+ * Usage:
+ *   StreamLexer lexer(arena, options);
+ *   TokenList line(arena);
+ *   while (size_t n = read(fd, buffer, size)) {
+ *       std::string_view bytes(buffer, n);
+ *       while (lexer.next(bytes, line)) {
+ *           handle(line);  // one complete line
+ *           line.clear();
+ *       }
+ *   }
+ *   lexer.finish(line);    // last line without '\n'
+ */
+class StreamLexer {
+  public:
+    /**
+     * @brief Constructor
+     * @param mr Memory resource for the token strings
+     * @param options Lexing settings
+     */
+    explicit StreamLexer(
+        std::pmr::memory_resource *mr = std::pmr::get_default_resource(),
+        LexerOptions options = {})
+        : mr(mr), options(options) {};
+
+    /**
+     * @brief Lexes bytes up to the end of the current line
+     * @param bytes Input; the bytes consumed are removed from its front
+     * @param tokens Receives the tokens completed
+     * @return true if a '\n' ended the line (bytes may hold more lines),
+     *         false if bytes ran out in the middle of a line (the state is
+     *         kept for the next chunk)
+     */
+    bool next(std::string_view &bytes, TokenList &tokens);
+
+    /**
+     * @brief Ends the input
+     * @param tokens Receives the token in progress, if any
+     */
+    void finish(TokenList &tokens);
+
+  private:
+    /// Token in progress
+    enum class State {
+        IDLE,      ///< Between tokens
+        NUMBER,    ///< Integer part of a number
+        GROUP,     ///< After a grouping separator, up to three digits
+        FRACTION,  ///< After the decimal separator
+        WORD,      ///< Keyword or unit
+        UTF8       ///< Inside a UTF-8 character of a word
+    };
+
+    /**
+     * @brief Ends the word in progress
+     * @param tokens The token stream
+     * @param tail Bytes of the word in the current chunk
+     */
+    void complete(TokenList &tokens, std::string_view tail);
+
+    /// Starts a UTF-8 character in a word at its lead byte
+    void startSequence(unsigned char lead);
+
+    /// Ends the number in progress
+    void completeNumber(TokenList &tokens);
+
+    /// The grouping separator was not followed by three digits: ends the
+    /// number before it, then lexes the separator and the digits again
+    void rejectGroup(TokenList &tokens);
+
+    /**
+     * @brief Appends a UNIT token if the word is a unit, after folding its
+     *        look-alike characters
+     * @param typos In lenient mode, also accept the only unit at edit
+     *        distance 1 (see UnitIndex), not just case variants and aliases
+     * @return false if nothing was appended
+     */
+    bool pushUnit(TokenList &tokens, std::string_view word, bool typos);
+
+    std::pmr::memory_resource *mr; ///< Allocator for the token strings
+    LexerOptions options;          ///< Lexing settings
+    State state = State::IDLE;     ///< Token in progress
+    std::string pending;   ///< Bytes of the word in progress from earlier
+                           ///< chunks
+    std::string number;    ///< Number in progress, rewritten with '.'
+    size_t groupStart = 0; ///< Start of the pending digit group in number
+    bool invalid = false;  ///< The word holds invalid UTF-8
+    int utf8Remaining = 0; ///< Continuation bytes left in the character
+    unsigned char utf8Lo = 0x80; ///< Bounds of the next continuation byte
+    unsigned char utf8Hi = 0xBF;
+};
@@ -1,6 +1,11 @@
 #pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 /**
  * @enum UnitType
@@ -17,8 +22,196 @@ enum class UnitType {
     TEMPERATURE, ///< Temperature units (°C, °F, K)
     AREA,        ///< Area/Surface units (m², km², acre, etc.)
     SPEED,       ///< Speed/Velocity units (m/s, km/h, mph, etc.)
-    PRESSURE     ///< Pressure units (Pa, bar, psi, atm, etc.)
+    PRESSURE,    ///< Pressure units (Pa, bar, psi, atm, etc.)
+    ENERGY,      ///< Energy units (J, kWh, kcal, BTU, etc.)
+    POWER,       ///< Power units (W, kW, hp) and power levels (dBm, dBW)
+    DATA,        ///< Data size units (B, kB, MiB, bit, etc.)
+    FLOW_RATE,   ///< Volumetric flow rate units (L/s, L/min, gpm, etc.)
+    FUEL_ECONOMY ///< Fuel consumption and economy (L/100km, km/L, mpg)
+};
+
+/**
+ * @enum ConversionKind
+ * @brief Shape of the function that maps a value from one unit to another
+ *
+ * Units are defined in the registry relative to the base unit of their
+ * dimension by one of the first four kinds; converting from a logarithmic
+ * unit back to a linear one gives the fifth.
+ */
+enum class ConversionKind {
+    LINEAR,      ///< x * scale
+    AFFINE,      ///< x * scale + offset (temperatures)
+    RECIPROCAL,  ///< scale / x (fuel economy: L/100km ↔ mpg)
+    LOGARITHMIC, ///< scale * ln(x) + offset (power → dBm)
+    EXPONENTIAL  ///< exp(x * scale + offset) (dBm → power)
+};
+
+/**
+ * @struct UnitEntry
+ * @brief One row of a unit table: a unit string and its value
+ *
+ * Members are named like those of std::pair so that a table lookup reads
+ * like a map lookup (it->first, it->second).
+ */
+template <typename V> struct UnitEntry {
+    std::string_view first; ///< Unit string
+    V second;               ///< Associated value
+};
+
+/**
+ * @brief Sorts the rows of a unit table at compile time
+ * @param rows Rows in source order (grouped by dimension)
+ * @return The rows sorted by unit string
+ *
+ * Insertion sort: the tables have at most a few hundred rows and are only
+ * sorted while compiling.
+ */
+template <typename V, size_t N>
+constexpr std::array<UnitEntry<V>, N>
+sortedTable(const UnitEntry<V> (&rows)[N]) {
+    std::array<UnitEntry<V>, N> sorted{};
+    for (size_t i = 0; i < N; i++) {
+        size_t j = i;
+        for (; j > 0 && rows[i].first < sorted[j - 1].first; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = rows[i];
+    }
+    return sorted;
+}
+
+/**
+ * @class UnitTable
+ * @brief Read-only map from unit strings to values, over a sorted array
+ *
+ * The registry tables are constant-initialized: their rows are sorted at
+ * compile time and live in read-only data, so no static constructor runs at
+ * startup and nothing is allocated. Lookups are binary searches, a handful
+ * of string comparisons for the table sizes of the registry.
+ */
+template <typename V> class UnitTable {
+  public:
+    using Entry = UnitEntry<V>;
+
+    /**
+     * @brief Wraps sorted rows
+     * @param rows Rows sorted by unit string, without duplicates (checked
+     *        at compile time for constant tables)
+     */
+    template <size_t N>
+    constexpr explicit UnitTable(const std::array<Entry, N> &sorted)
+        : rows(sorted.data()), length(N) {
+        for (size_t i = 1; i < N; i++) {
+            if (!(sorted[i - 1].first < sorted[i].first)) {
+                throw std::logic_error("Table d'unités non triée");
+            }
+        }
+    }
+
+    constexpr const Entry *begin() const { return rows; }
+    constexpr const Entry *end() const { return rows + length; }
+    constexpr size_t size() const { return length; }
+
+    /// Row of unit, or end() if unknown
+    constexpr const Entry *find(std::string_view unit) const {
+        size_t low = 0;
+        size_t high = length;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (rows[mid].first < unit) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low < length && rows[low].first == unit ? rows + low : end();
+    }
+
+    /// Value of unit
+    /// @throw std::out_of_range if unit is unknown
+    const V &at(std::string_view unit) const {
+        const Entry *entry = find(unit);
+        if (entry == end()) {
+            throw std::out_of_range(
+                std::string("Unité inconnue: ").append(unit));
+        }
+        return entry->second;
+    }
+
+  private:
+    const Entry *rows;
+    size_t length;
 };
 
 /// @brief Global mapping of unit strings to their types
-extern std::unordered_map<std::string, UnitType> UnitSet;
+///
+/// Keys are views on string literals, so lookups from a token or a
+/// std::string_view never allocate.
+extern const UnitTable<UnitType> UnitSet;
+
+/// @brief Factor from each linear unit to the base unit of its dimension
+/// (kg, m, L, s, m², m/s, Pa, J, W, B, L/s, L/100km), exact where the unit
+/// has a legal definition. Derived at compile time from the definitions of
+/// the registry; affine, reciprocal and logarithmic units are not listed,
+/// they cannot be combined in an expression.
+extern const UnitTable<double> UnitFactors;
+
+/// @brief Alternative spellings (full names, plurals) mapped to the
+/// canonical unit string of UnitSet. Only used by the lenient Lexer mode.
+extern const UnitTable<std::string_view> UnitAliases;
+
+/**
+ * @struct Coefficients
+ * @brief Map between two units, see ConversionKind for how scale and offset
+ *        apply
+ */
+struct Coefficients {
+    ConversionKind kind; ///< Shape of the map
+    double scale;        ///< Multiplier
+    double offset;       ///< Added term (0 for LINEAR and RECIPROCAL)
+};
+
+/**
+ * @brief Coefficients from one unit to another of the same dimension
+ *
+ * Every pair is computed at compile time in extended precision from the
+ * registry definitions and rounded once to double, then stored in a table.
+ * Evaluating x * scale in double and rounding to float gives the float
+ * nearest to the exact result (up to double rounding), so converting a
+ * linear quantity there and back returns within 1 ULP of the input.
+ *
+ * @throw std::out_of_range if a unit is unknown or the dimensions differ
+ */
+Coefficients pairCoefficients(std::string_view from, std::string_view to);
+
+/// @brief Identifier of a unit: its index in UnitSet
+using UnitId = uint16_t;
+
+/// @brief Identifier of an ordered pair of units of the same dimension,
+/// dense in [0, pairCount()): the index of its coefficients in the table
+/// of pairCoefficients()
+using PairId = uint32_t;
+
+/// @brief Identifier of a unit string of UnitSet, std::nullopt if unknown
+std::optional<UnitId> unitId(std::string_view unit);
+
+/// @brief Unit string of an identifier
+std::string_view unitName(UnitId id);
+
+/// @brief Pair from → to, std::nullopt if the dimensions differ
+std::optional<PairId> pairId(UnitId from, UnitId to);
+
+/// @brief Number of pairs: one past the largest PairId
+size_t pairCount();
+
+/// @brief Coefficients of a pair, as pairCoefficients(from, to)
+Coefficients pairCoefficients(PairId pair);
+
+/// @brief Base unit of a dimension: the linear unit of factor 1 in
+/// UnitFactors, in which expressions are evaluated
+std::string_view baseUnit(UnitType type);
+
+/// @brief Fingerprint of the unit registry (UnitSet, unit definitions,
+/// UnitAliases). Any added unit, alias or changed factor gives another
+/// value, so results persisted by a previous build can be invalidated.
+uint64_t registryVersion();
@@ -0,0 +1,116 @@
+#pragma once
+#include "Unit.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class UnitIndex
+ * @brief Approximate lookup index over unit spellings
+ *
+ * Indexes every unit string of UnitSet and every alias of UnitAliases with
+ * a symmetric-delete scheme: each spelling is registered under the hash of
+ * every variant obtained by deleting up to MAX_DISTANCE code points. Two
+ * strings within edit distance k share such a variant, so a query only
+ * hashes the deletion variants of the word (a few dozen for a unit) and
+ * verifies the handful of candidates with an exact Levenshtein distance.
+ * The cost does not depend on the number of indexed units.
+ *
+ * A case-folded table answers case-insensitive and alias lookups in O(1).
+ *
+ * Usage:
+ *   const UnitIndex &index = UnitIndex::global();
+ *   index.suggest("kpa");  // {"kPa", "Pa"}
+ *   index.resolve("KPA");  // "kPa"
+ */
+class UnitIndex {
+  public:
+    /// Largest edit distance the index can answer
+    static constexpr size_t MAX_DISTANCE = 2;
+
+    /**
+     * @brief Builds the index
+     * @param units Canonical unit spellings
+     * @param aliases Alternative spellings mapped to canonical ones
+     */
+    UnitIndex(const UnitTable<UnitType> &units,
+              const UnitTable<std::string_view> &aliases);
+
+    /**
+     * @brief Index over UnitSet and UnitAliases, built on first use
+     */
+    static const UnitIndex &global();
+
+    /**
+     * @brief Exact lookup ignoring case, through the aliases
+     * @param word The spelling to resolve
+     * @return The canonical unit, or nothing if unknown or ambiguous
+     *         (several units differing only by case, none lowercase)
+     */
+    [[nodiscard]] std::optional<std::string_view>
+    resolve(std::string_view word) const;
+
+    /**
+     * @brief Closest canonical units within an edit distance
+     * @param word The misspelled unit
+     * @param maxDistance Maximum Levenshtein distance (in code points),
+     *        clamped to MAX_DISTANCE
+     * @param maxResults Maximum number of suggestions
+     * @return Canonical units, closest first, without duplicates; none for
+     *         a word longer than every spelling by more than maxDistance
+     */
+    [[nodiscard]] std::vector<std::string_view>
+    suggest(std::string_view word, size_t maxDistance = 2,
+            size_t maxResults = 3) const;
+
+    /**
+     * @brief Unique closest canonical unit (lenient parsing)
+     * @param word The misspelled unit
+     * @param maxDistance Maximum Levenshtein distance (in code points),
+     *        clamped to MAX_DISTANCE
+     * @return The canonical unit, or nothing if none or several are closest
+     */
+    [[nodiscard]] std::optional<std::string_view>
+    closest(std::string_view word, size_t maxDistance = 1) const;
+
+    /**
+     * @brief Levenshtein distance between two UTF-8 strings, in code points
+     */
+    static size_t distance(std::string_view a, std::string_view b);
+
+  private:
+    /// A candidate within the distance of a query
+    struct Match {
+        std::string_view unit; ///< Canonical unit
+        size_t distance;       ///< Edit distance to the query
+    };
+
+    /// An indexed spelling
+    struct Entry {
+        std::u32string spelling;    ///< Indexed spelling, decoded once
+        std::string_view canonical; ///< Unit it stands for
+    };
+
+    void insert(std::string_view spelling, std::string_view canonical);
+    std::vector<Match> query(std::string_view word, size_t maxDistance) const;
+
+    /// Levenshtein distance between two decoded strings
+    static size_t distance(std::u32string_view a, std::u32string_view b);
+
+    /// Calls f(hash) for every variant of s with up to maxDeletes code
+    /// points removed
+    template <typename F>
+    static void forEachDeletion(std::u32string_view s, size_t maxDeletes,
+                                F &&f);
+
+    std::vector<Entry> entries; ///< Indexed spellings
+    /// Length of the longest indexed spelling, in code points
+    size_t longest = 0;
+    /// Hash of a deletion variant → entries having it
+    std::unordered_map<uint64_t, std::vector<uint32_t>> deletions;
+    /// Lowercase spelling → canonical unit (empty view when ambiguous)
+    std::unordered_map<std::string, std::string_view> folded;
+};
@@ -9,11 +9,63 @@
  *   ./Convertisseur "convert 1.3 kg to lb"
  *   ./Convertisseur "convert 100 m to ft"
  *   ./Convertisseur "convert 25 C to F"
+ *   ./Convertisseur --file requests.txt   (one request per line, - = stdin)
+ *   ./Convertisseur --file requests.txt --cache results.cache
+ *   ./Convertisseur --file requests.txt --jobs 8
+ *   ./Convertisseur --file requests.txt --store float16
+ *   ./Convertisseur --file samples.txt --resample 60 mph m/s
+ *   ./Convertisseur --ring /samples /converted   (shared-memory rings)
+ *   ./Convertisseur --lenient "convert 3 Feet to meters"
+ *   ./Convertisseur --decimal , --grouping ' ' "convert 1 234,5 m to ft"
  */
 
+#include "include/AsyncIO.hpp"
 #include "include/Convertisseur.hpp"
+#include "include/RequestBatch.hpp"
+#include "include/Resampler.hpp"
+#include "include/ResultCache.hpp"
+#include "include/Scheduler.hpp"
+#include "include/ShmRing.hpp"
+#include "include/Storage.hpp"
+#include "include/StreamLexer.hpp"
+#include "include/Unit.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+/// Number of lines converted between two releases of the bulk arena; also
+/// the chunk size of the result cache
+constexpr size_t BATCH_LINES = 1024;
+
+/// Bytes read at a time in bulk mode without cache
+constexpr size_t READ_BYTES = 64 * 1024;
+
+/// Input handed to the workers at a time with --jobs
+constexpr size_t WINDOW_BYTES = 4 * 1024 * 1024;
+
+/// Size below which a piece of a window is not split further: its bytes,
+/// tokens and results stay in the cache of the core converting it
+constexpr size_t SPLIT_BYTES = 32 * 1024;
+
+/// Size of the inline arena buffer; a batch that outgrows it falls back to
+/// the heap until the next release
+constexpr size_t ARENA_BYTES = 256 * 1024;
 
 /**
  * @brief Displays usage information and supported unit types
@@ -23,6 +75,38 @@ void printUsage(const char *programName) {
     std::cout << "=== UNIT CONVERTER ===" << std::endl << std::endl;
     std::cout << "Usage: " << programName
               << " \"convert <value> <source_unit> to <target_unit>\""
+              << std::endl;
+    std::cout << "       " << programName << " --file <path|-> [--cache <path>]"
+              << std::endl;
+    std::cout << "       " << programName
+              << " --file <path|-> --resample <window> <source_unit> "
+                 "<target_unit>"
+              << std::endl;
+    std::cout << "       " << programName << " --ring <input> <output>"
+              << std::endl;
+    std::cout << "Options: --lenient  accept case variants, full names "
+                 "and typos for units"
+              << std::endl;
+    std::cout << "         --cache    reuse the results of unchanged chunks "
+                 "from previous runs"
+              << std::endl;
+    std::cout << "         --decimal <c>, --grouping <c>  number format, "
+                 "e.g. \"1 234,5\" with --decimal , --grouping ' '"
+              << std::endl;
+    std::cout << "         --sync-io  blocking reads and writes instead of "
+                 "io_uring"
+              << std::endl;
+    std::cout << "         --jobs <n> convert on n threads (0 = one per "
+                 "core)"
+              << std::endl;
+    std::cout << "         --ring     convert binary (value, from id, to id) "
+                 "records of a shared-memory ring into another"
+              << std::endl;
+    std::cout << "         --store <float16|bfloat16|fixed16>  round plain "
+                 "results to 16-bit codes, report the error (--file, --ring)"
+              << std::endl;
+    std::cout << "         --resample read \"<timestamp> <value>\" lines, print "
+                 "\"<start> <mean> <min> <max> <count>\" per window"
               << std::endl
               << std::endl;
 
@@ -41,14 +125,786 @@ void printUsage(const char *programName) {
         << std::endl;
     std::cout << "SPEED: m/s, km/h, mph, ft/s, knot, kn" << std::endl;
     std::cout << "PRESSURE: Pa, kPa, MPa, bar, mbar, psi, atm, mmHg, inHg"
-              << std::endl
               << std::endl;
+    std::cout << "ENERGY: J, kJ, MJ, cal, kcal, Wh, kWh, BTU, eV" << std::endl;
+    std::cout << "POWER: W, kW, MW, hp, dBW, dBm" << std::endl;
+    std::cout << "DATA: B, kB, MB, GB, TB, KiB, MiB, GiB, TiB, bit, kbit, "
+                 "Mbit, Gbit"
+              << std::endl;
+    std::cout << "FLOW_RATE: L/s, L/min, L/h, mL/min, m³/s, m3/s, m³/h, m3/h, "
+                 "gal/min, gpm"
+              << std::endl;
+    std::cout << "FUEL_ECONOMY: L/100km, km/L, mpg" << std::endl << std::endl;
 
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << programName << " \"convert 1.3 kg to lb\""
               << std::endl;
     std::cout << "  " << programName << " \"convert 100 m to ft\"" << std::endl;
     std::cout << "  " << programName << " \"convert 25 C to F\"" << std::endl;
+    std::cout << "  " << programName << " \"convert 100 km/h to mph, knot\""
+              << std::endl;
+}
+
+/**
+ * @struct CliOptions
+ * @brief Parsed command-line arguments
+ */
+struct CliOptions {
+    std::string input;    ///< One-shot conversion request
+    std::string file;     ///< Bulk mode input path ("-" = stdin)
+    std::string cache;    ///< Result cache file of the bulk mode (--cache)
+    LexerOptions lexer;   ///< Lexing settings (--lenient, --decimal...)
+    bool syncIO = false;  ///< Blocking reads and writes (--sync-io)
+    unsigned jobs = 1;    ///< Worker threads (--jobs, 0 = one per core)
+    int64_t window = 0;   ///< Resampling window length (0 = no resampling)
+    std::string fromUnit; ///< Unit of the resampled values
+    std::string toUnit;   ///< Unit of the resampled aggregates
+    std::string ringIn;   ///< Shared-memory ring of requests (--ring)
+    std::string ringOut;  ///< Shared-memory ring of results (--ring)
+    std::optional<StorageFormat> store; ///< 16-bit results (--store)
+};
+
+/**
+ * @brief Reads the separator of --decimal or --grouping
+ * @return false unless arg is one character, neither a digit nor a letter
+ */
+bool parseSeparator(const std::string &arg, char &separator) {
+    auto c = static_cast<unsigned char>(arg[0]);
+    if (arg.size() != 1 || std::isalnum(c) || c == '\n') {
+        return false;
+    }
+    separator = arg[0];
+    return true;
+}
+
+/**
+ * @brief Parses the command-line arguments
+ * @return The options, or nothing if the arguments are invalid
+ */
+std::optional<CliOptions> parseArguments(int argc, char *argv[]) {
+    CliOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--lenient") {
+            options.lexer.lenient = true;
+        } else if (arg == "--decimal" && i + 1 < argc) {
+            if (!parseSeparator(argv[++i], options.lexer.numbers.decimal)) {
+                return std::nullopt;
+            }
+        } else if (arg == "--grouping" && i + 1 < argc) {
+            if (!parseSeparator(argv[++i], options.lexer.numbers.grouping)) {
+                return std::nullopt;
+            }
+        } else if (arg == "--sync-io") {
+            options.syncIO = true;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            char *end;
+            unsigned long jobs = std::strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || end == argv[i] || jobs > 1024) {
+                return std::nullopt;
+            }
+            options.jobs = static_cast<unsigned>(jobs);
+        } else if (arg == "--file" && i + 1 < argc) {
+            options.file = argv[++i];
+        } else if (arg == "--cache" && i + 1 < argc) {
+            options.cache = argv[++i];
+        } else if (arg == "--resample" && i + 3 < argc) {
+            char *end;
+            options.window = std::strtoll(argv[++i], &end, 10);
+            if (*end != '\0' || options.window <= 0) {
+                return std::nullopt;
+            }
+            options.fromUnit = argv[++i];
+            options.toUnit = argv[++i];
+        } else if (arg == "--store" && i + 1 < argc) {
+            options.store = storageFormat(argv[++i]);
+            if (!options.store.has_value()) {
+                return std::nullopt;
+            }
+        } else if (arg == "--ring" && i + 2 < argc) {
+            options.ringIn = argv[++i];
+            options.ringOut = argv[++i];
+        } else if (options.input.empty() && arg.rfind("--", 0) != 0) {
+            options.input = arg;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    // Exactement un mode: requête unique, fichier ou anneaux
+    int modes = !options.input.empty() + !options.file.empty() +
+                !options.ringIn.empty();
+    if (modes != 1) {
+        return std::nullopt;
+    }
+    // Les anneaux ne passent pas par le Lexer: aucune option de lecture
+    if (!options.ringIn.empty() &&
+        (options.lexer.lenient || options.syncIO ||
+         options.lexer.numbers.decimal != NumberFormat{}.decimal ||
+         options.lexer.numbers.grouping != NumberFormat{}.grouping)) {
+        return std::nullopt;
+    }
+    // Le cache et le rééchantillonnage ne servent qu'au mode fichier, et
+    // pas ensemble
+    if ((!options.cache.empty() || options.window > 0) &&
+        options.file.empty()) {
+        return std::nullopt;
+    }
+    if (!options.cache.empty() && options.window > 0) {
+        return std::nullopt;
+    }
+    // Le stockage 16 bits ne sert qu'aux requêtes simples, converties par
+    // lot: fichier sans cache (les rapports d'erreur des morceaux repris du
+    // cache seraient perdus) ou anneaux
+    if (options.store.has_value() &&
+        (!options.input.empty() || !options.cache.empty() ||
+         options.window > 0)) {
+        return std::nullopt;
+    }
+    // Les workers ne servent qu'au mode fichier sans cache
+    if (options.jobs != 1 && (options.file.empty() ||
+                              !options.cache.empty() || options.window > 0)) {
+        return std::nullopt;
+    }
+    if (options.lexer.numbers.decimal == options.lexer.numbers.grouping) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+/// A line that failed to convert
+struct LineError {
+    size_t line;         ///< Line number
+    std::string message; ///< Reason
+};
+
+/**
+ * @class BatchedLines
+ * @brief Results of a run of lines in input order, the plain requests
+ *        converted together
+ *
+ * A plain request ("convert 3.5 km to mi") is appended to a RequestBatch;
+ * any other line is converted on its own and its result kept as text.
+ * write() converts the batch, grouped by unit pair, then prints every line
+ * in input order, as Convertisseur would have.
+ *
+ * With a storage format (--store), the results of the plain requests are
+ * rounded to their 16-bit codes and printed decoded; the errors are
+ * accumulated per target unit (reports()). Other lines are unchanged.
+ */
+class BatchedLines {
+  public:
+    /// @param store 16-bit format of the plain results, if any
+    explicit BatchedLines(std::optional<StorageFormat> store = std::nullopt)
+        : store(store) {}
+
+    /**
+     * @brief Queues a plain request, converts any other one
+     * @param tokens The lexed line
+     * @param plans Plans of the lines that are not plain
+     * @throw std::runtime_error if the line fails; nothing is kept of it
+     */
+    void add(TokenList tokens, PlanCache &plans) {
+        if (batch.push(tokens)) {
+            ends.push_back(ROW);
+            return;
+        }
+        Convertisseur converter(std::move(tokens), plans);
+        converter.convert(text);
+        ends.push_back(static_cast<size_t>(text.tellp()));
+    }
+
+    /// Prints the results of the lines added since the last call
+    void write(std::ostream &out) {
+        results.resize(batch.size());
+        if (store.has_value()) {
+            batch.convertStored(*store, results.data(), storeReports);
+        } else {
+            batch.convert(results.data());
+        }
+
+        std::string other = text.str();
+        size_t row = 0;
+        size_t start = 0;
+        for (size_t end : ends) {
+            if (end == ROW) {
+                out << batch.valueColumn()[row] << ' '
+                    << unitName(batch.fromColumn()[row]) << " = "
+                    << results[row] << ' ' << unitName(batch.toColumn()[row])
+                    << '\n';
+                row++;
+            } else {
+                out.write(other.data() + start,
+                          static_cast<std::streamsize>(end - start));
+                start = end;
+            }
+        }
+
+        batch.clear();
+        ends.clear();
+        text.str("");
+    }
+
+    /// Errors of the storage format per target unit, indexed by UnitId
+    /// (empty without a format)
+    const std::vector<PrecisionReport> &reports() const {
+        return storeReports;
+    }
+
+  private:
+    /// Marks a line of the batch in ends
+    static constexpr size_t ROW = SIZE_MAX;
+
+    RequestBatch batch;       ///< Plain requests
+    std::ostringstream text;  ///< Results of the other lines
+    std::vector<size_t> ends; ///< Per line: end of its text, or ROW
+    std::vector<float> results;
+    std::optional<StorageFormat> store;        ///< 16-bit plain results
+    std::vector<PrecisionReport> storeReports; ///< See reports()
+};
+
+/**
+ * @brief Converts the lines of one chunk
+ * @param chunk Lines, each terminated by '\n'
+ * @param firstLine Number of the first line (error messages)
+ * @param plans Plans shared by the whole run
+ * @param arena Memory resource for the lexer/parser state
+ * @param lexerOptions Lexing settings applied to every line
+ * @param lines Batch of the plain requests, empty between two chunks
+ * @param out Stream the results are printed to
+ * @param errors Receives the lines that failed
+ */
+void convertChunk(std::string_view chunk, size_t firstLine, PlanCache &plans,
+                  std::pmr::memory_resource *arena, LexerOptions lexerOptions,
+                  BatchedLines &lines, std::ostream &out,
+                  std::vector<LineError> &errors) {
+    size_t lineNumber = firstLine;
+
+    for (size_t start = 0; start < chunk.size(); lineNumber++) {
+        size_t end = chunk.find('\n', start);
+        std::string_view line = chunk.substr(start, end - start);
+        start = end + 1;
+        if (line.empty()) {
+            continue;
+        }
+
+        try {
+            lines.add(Lexer(line, arena, lexerOptions).lex(), plans);
+        } catch (const std::exception &e) {
+            errors.push_back({lineNumber, e.what()});
+        }
+    }
+    lines.write(out);
+}
+
+/**
+ * @brief Prints errors on stderr, line numbers shifted by offset
+ */
+void printErrors(const std::vector<LineError> &errors, size_t offset = 0) {
+    for (const LineError &error : errors) {
+        std::cerr << "Error (line " << error.line + offset
+                  << "): " << error.message << std::endl;
+    }
+}
+
+/**
+ * @brief Adds the storage errors of from to into, unit by unit
+ * @param into Reports indexed by UnitId, resized as needed
+ * @param from Reports indexed by UnitId
+ */
+void mergeReports(std::vector<PrecisionReport> &into,
+                  const std::vector<PrecisionReport> &from) {
+    into.resize(std::max(into.size(), from.size()));
+    for (size_t id = 0; id < from.size(); id++) {
+        into[id].step = std::max(into[id].step, from[id].step);
+        into[id].merge(from[id]);
+    }
+}
+
+/**
+ * @brief Prints the storage errors of each target unit on stderr (--store)
+ * @param format Format the results were rounded to
+ * @param reports Reports indexed by UnitId
+ */
+void printStoreReports(StorageFormat format,
+                       const std::vector<PrecisionReport> &reports) {
+    for (size_t id = 0; id < reports.size(); id++) {
+        const PrecisionReport &report = reports[id];
+        if (report.count == 0) {
+            continue;
+        }
+        std::cerr << "Store " << storageName(format) << ' '
+                  << unitName(static_cast<UnitId>(id)) << ": " << report.count
+                  << " values, max abs error " << std::defaultfloat
+                  << std::setprecision(3) << report.maxAbsError
+                  << ", max rel error " << report.maxRelError
+                  << ", rms error " << report.rmsError() << ", "
+                  << report.overflows << " overflows";
+        if (format == StorageFormat::FIXED16) {
+            std::cerr << ", step up to " << report.step;
+        }
+        std::cerr << std::endl;
+    }
+}
+
+/**
+ * @brief Cache seed of the lexing settings: the same chunk converts
+ *        differently in lenient mode or with another number format
+ */
+uint64_t cacheSeed(const LexerOptions &options) {
+    return static_cast<uint64_t>(options.lenient) |
+           static_cast<uint64_t>(
+               static_cast<unsigned char>(options.numbers.decimal))
+               << 8 |
+           static_cast<uint64_t>(
+               static_cast<unsigned char>(options.numbers.grouping))
+               << 16;
+}
+
+/**
+ * @brief Converts every line of a stream (bulk mode with result cache)
+ * @param in Input stream, one conversion request per line
+ * @param lexerOptions Lexing settings applied to every line
+ * @param cache Results of previous runs
+ * @return Number of lines that failed
+ *
+ * The input is read in chunks of BATCH_LINES lines, the unit of the cache.
+ * Lexer and parser state is allocated from a monotonic arena which is
+ * released after each chunk, so the allocator is almost never hit and the
+ * memory footprint stays flat whatever the input size. Only the first line
+ * of each request shape is parsed and compiled (PlanCache).
+ *
+ * A chunk already converted by a previous run is copied through untouched.
+ * Only chunks without errors are cached, so error messages (and the exit
+ * status) are always reproduced.
+ */
+size_t convertStream(std::istream &in, LexerOptions lexerOptions,
+                     ResultCache &cache) {
+    static std::array<std::byte, ARENA_BYTES> buffer;
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    PlanCache plans;
+    BatchedLines batched;
+
+    std::string chunk;
+    std::string line;
+    std::ostringstream output;
+    std::vector<LineError> errors;
+    size_t lineNumber = 0;
+    size_t failures = 0;
+
+    while (true) {
+        chunk.clear();
+        size_t lines = 0;
+        while (lines < BATCH_LINES && std::getline(in, line)) {
+            chunk.append(line).push_back('\n');
+            lines++;
+        }
+        if (lines == 0) {
+            break;
+        }
+
+        uint64_t key = ResultCache::chunkKey(chunk, cacheSeed(lexerOptions));
+        if (auto cached = cache.find(key)) {
+            std::cout << *cached;
+        } else {
+            output.str("");
+            errors.clear();
+            convertChunk(chunk, lineNumber + 1, plans, &arena, lexerOptions,
+                         batched, output, errors);
+            printErrors(errors);
+            std::cout << output.str();
+            if (errors.empty()) {
+                cache.insert(key, output.str());
+            }
+            failures += errors.size();
+        }
+
+        lineNumber += lines;
+        arena.release();
+    }
+
+    return failures;
+}
+
+/**
+ * @brief Converts every line of a file, lexed straight from read blocks
+ * @param in Input file descriptor, one conversion request per line
+ * @param options Lexing settings applied to every line, I/O mode
+ * @return Number of lines that failed
+ *
+ * The input is read in blocks of READ_BYTES and fed to a StreamLexer, so
+ * no line is copied out of the read buffer: a line, number or UTF-8 unit
+ * split between two blocks is carried over by the lexer. The arena is
+ * released every BATCH_LINES lines, between two lines. The plain requests
+ * of these lines are converted together, grouped by unit pair
+ * (BatchedLines).
+ *
+ * Reads of the next blocks and the write of the previous results are in
+ * flight while a block is converted (AsyncIO over io_uring), so one thread
+ * keeps the disk busy. Results are written a buffer at a time, not a line
+ * at a time.
+ */
+size_t convertBlocks(int in, const CliOptions &options) {
+    static std::array<std::byte, ARENA_BYTES> buffer;
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    PlanCache plans;
+    StreamLexer lexer(&arena, options.lexer);
+    TokenList line(&arena);
+    AsyncIO io(in, STDOUT_FILENO, !options.syncIO, READ_BYTES);
+    std::ostream out(&io);
+    BatchedLines lines(options.store);
+    size_t lineNumber = 0;
+    size_t failures = 0;
+
+    auto convertLine = [&] {
+        lineNumber++;
+        if (!line.empty()) {
+            try {
+                lines.add(std::move(line), plans);
+            } catch (const std::exception &e) {
+                std::cerr << "Error (line " << lineNumber << "): " << e.what()
+                          << std::endl;
+                failures++;
+            }
+        }
+        line = TokenList(&arena);
+        if (lineNumber % BATCH_LINES == 0) {
+            lines.write(out);
+            arena.release();
+        }
+    };
+
+    std::string_view bytes;
+    while (io.read(bytes)) {
+        while (lexer.next(bytes, line)) {
+            convertLine();
+        }
+    }
+    lexer.finish(line);
+    if (!line.empty()) {
+        convertLine();
+    }
+    lines.write(out);
+    io.finish();
+    if (options.store.has_value()) {
+        printStoreReports(*options.store, lines.reports());
+    }
+    return failures;
+}
+
+/// Results of the lines starting in one piece of a window (--jobs)
+struct Piece {
+    size_t begin;                  ///< Offset of its first line
+    size_t lines;                  ///< Number of lines
+    std::string output;            ///< Their results
+    std::vector<LineError> errors; ///< Numbered from 1 within the piece
+};
+
+/// State of one worker of convertParallel(), on its own cache lines
+struct alignas(64) WorkerState {
+    PlanCache plans; ///< Plans compiled by this worker
+    std::pmr::monotonic_buffer_resource arena{ARENA_BYTES}; ///< Per piece
+    BatchedLines lines; ///< Plain requests of the current piece
+    std::vector<Piece> pieces; ///< Pieces converted in the current window
+};
+
+/**
+ * @brief Prints the utilization and steal count of each worker on stderr
+ */
+void printWorkerStats(const Scheduler &scheduler) {
+    double elapsed = scheduler.elapsed();
+    auto stats = scheduler.stats();
+    for (size_t i = 0; i < stats.size(); i++) {
+        std::cerr << "Worker " << i << ": " << std::fixed
+                  << std::setprecision(1)
+                  << (elapsed > 0.0 ? 100.0 * stats[i].busy / elapsed : 0.0)
+                  << " % busy, " << stats[i].tasks << " tasks, "
+                  << stats[i].steals << " steals" << std::endl;
+    }
+}
+
+/**
+ * @brief Converts every line of a file on several threads (--jobs)
+ * @param in Input file descriptor, one conversion request per line
+ * @param options Lexing settings, I/O mode and number of workers
+ * @return Number of lines that failed
+ *
+ * The input is read by windows of WINDOW_BYTES, cut after their last
+ * complete line. Each window is split in halves by a Scheduler down to
+ * pieces of SPLIT_BYTES, which idle workers steal: a window of short lines
+ * and one of long, costly requests keep every core busy alike. A piece
+ * converts the lines starting in its byte range into its own buffer; the
+ * buffers are then written in input order, with their errors renumbered.
+ *
+ * Each worker has its own PlanCache and arena, so workers share nothing
+ * but the read-only unit registry.
+ */
+size_t convertParallel(int in, const CliOptions &options) {
+    Scheduler scheduler(options.jobs);
+    std::vector<WorkerState> workers(scheduler.size());
+    for (WorkerState &worker : workers) {
+        worker.lines = BatchedLines(options.store);
+    }
+    AsyncIO io(in, STDOUT_FILENO, !options.syncIO, READ_BYTES);
+    std::ostream out(&io);
+
+    std::string window;
+    size_t scanned = 0; // octets de window déjà cherchés sans '\n'
+    std::string_view bytes;
+    std::vector<Piece> pieces;
+    size_t lineNumber = 0;
+    size_t failures = 0;
+    bool more = true;
+
+    // Seuls les octets lus depuis la dernière recherche sont relus: une
+    // très longue ligne reste linéaire
+    auto hasLine = [&] {
+        size_t newline = window.find('\n', scanned);
+        scanned = newline == std::string::npos ? window.size() : newline;
+        return newline != std::string::npos;
+    };
+
+    while (more) {
+        // Au moins une ligne complète, sauf à la fin de l'entrée
+        while ((window.size() < WINDOW_BYTES || !hasLine()) &&
+               (more = io.read(bytes))) {
+            window.append(bytes);
+        }
+        if (!more && !window.empty() && window.back() != '\n') {
+            window.push_back('\n');
+        }
+        std::string_view lines(window.data(), window.rfind('\n') + 1);
+
+        // Une pièce prend les lignes qui commencent dans [begin, end)
+        scheduler.parallelFor(
+            0, lines.size(), SPLIT_BYTES, [&](size_t begin, size_t end) {
+                // Début cherché dans la pièce seule: celles du milieu d'une
+                // longue ligne ne la parcourent pas jusqu'au bout
+                size_t first = 0;
+                if (begin != 0) {
+                    first = lines.substr(0, end - 1).find('\n', begin - 1) + 1;
+                    if (first == 0) {
+                        return;
+                    }
+                }
+                size_t last = lines.find('\n', end - 1) + 1;
+                std::string_view chunk = lines.substr(first, last - first);
+                WorkerState &worker = workers[Scheduler::currentWorker()];
+                Piece piece{first, static_cast<size_t>(std::count(
+                                       chunk.begin(), chunk.end(), '\n')),
+                            {}, {}};
+                std::ostringstream output;
+                convertChunk(chunk, 1, worker.plans, &worker.arena,
+                             options.lexer, worker.lines, output,
+                             piece.errors);
+                piece.output = std::move(output).str();
+                worker.arena.release();
+                worker.pieces.push_back(std::move(piece));
+            });
+        scheduler.wait();
+
+        pieces.clear();
+        for (WorkerState &worker : workers) {
+            std::move(worker.pieces.begin(), worker.pieces.end(),
+                      std::back_inserter(pieces));
+            worker.pieces.clear();
+        }
+        std::sort(pieces.begin(), pieces.end(),
+                  [](const Piece &a, const Piece &b) {
+                      return a.begin < b.begin;
+                  });
+        for (const Piece &piece : pieces) {
+            printErrors(piece.errors, lineNumber);
+            out << piece.output;
+            failures += piece.errors.size();
+            lineNumber += piece.lines;
+        }
+        // Le reste suit le dernier '\n': il n'en contient aucun
+        window.erase(0, lines.size());
+        scanned = window.size();
+    }
+
+    io.finish();
+    printWorkerStats(scheduler);
+    if (options.store.has_value()) {
+        std::vector<PrecisionReport> reports;
+        for (const WorkerState &worker : workers) {
+            mergeReports(reports, worker.lines.reports());
+        }
+        printStoreReports(*options.store, reports);
+    }
+    return failures;
+}
+
+/**
+ * @brief Runs the bulk mode on a stream through the result cache
+ * @return Number of lines that failed
+ */
+size_t convertFile(std::istream &in, const CliOptions &options) {
+    ResultCache cache(options.cache, registryVersion());
+    size_t failures = convertStream(in, options.lexer, cache);
+
+    size_t lookups = cache.hits() + cache.misses();
+    std::cerr << "Cache: " << cache.hits() << "/" << lookups
+              << " chunks reused (" << std::fixed << std::setprecision(1)
+              << (lookups == 0 ? 0.0 : 100.0 * cache.hits() / lookups)
+              << " %)" << std::endl;
+    try {
+        cache.save();
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+    return failures;
+}
+
+/**
+ * @brief Prints resampled windows
+ */
+void printWindows(std::vector<Window> &windows) {
+    for (const Window &w : windows) {
+        std::cout << w.start << ' ' << w.mean << ' ' << w.min << ' ' << w.max
+                  << ' ' << w.count << '\n';
+    }
+    windows.clear();
+}
+
+/**
+ * @brief Reads the value of a sample (--resample)
+ * @param text Rest of the line after the timestamp
+ * @param numbers Number format of the stream (--decimal, --grouping)
+ * @return The value, or nothing unless text is one finite number
+ *
+ * In the default format, any strtof() number is read ("1e-3"). In another
+ * format the value is lexed as in a request, with the same separator rules
+ * ("-1 234,5" with --decimal , --grouping ' ').
+ */
+std::optional<float> sampleValue(const char *text, NumberFormat numbers) {
+    if (numbers.decimal == NumberFormat{}.decimal &&
+        numbers.grouping == NumberFormat{}.grouping) {
+        char *end;
+        float value = std::strtof(text, &end);
+        const char *valueEnd = end;
+        while (*end == ' ' || *end == '\t' || *end == '\r') {
+            end++;
+        }
+        if (valueEnd == text || *end != '\0' || !std::isfinite(value)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    LexerOptions options;
+    options.numbers = numbers;
+    TokenList tokens =
+        Lexer(text, std::pmr::get_default_resource(), options).lex();
+    bool negative = !tokens.empty() &&
+                    tokens[0].type == TokenType::OPERATOR &&
+                    tokens[0].value == "-";
+    if (tokens.size() != 1 + size_t{negative} ||
+        tokens.back().type != TokenType::DECIMAL) {
+        return std::nullopt;
+    }
+    auto value = decimalValue(tokens.back().value);
+    if (!value.has_value() || !std::isfinite(*value)) {
+        return std::nullopt;
+    }
+    return negative ? -*value : *value;
+}
+
+/**
+ * @brief Resamples a time series with unit conversion (--resample)
+ * @param in Input stream, one "<timestamp> <value>" sample per line
+ * @param options Window length and units
+ * @return Number of lines that failed
+ *
+ * Samples are read into blocks of BATCH_LINES and handed to a Resampler,
+ * which prints one line per window: "<start> <mean> <min> <max> <count>",
+ * in the target unit. A sample that cannot be read, is outside the domain
+ * of the conversion or goes back to a past window is reported with its
+ * line number and left out.
+ */
+size_t resampleStream(std::istream &in, const CliOptions &options) {
+    Resampler resampler(options.fromUnit, options.toUnit, options.window);
+    std::vector<int64_t> timestamps;
+    std::vector<float> values;
+    std::vector<Window> windows;
+    timestamps.reserve(BATCH_LINES);
+    values.reserve(BATCH_LINES);
+
+    auto pushBlock = [&] {
+        resampler.push(timestamps.data(), values.data(), timestamps.size(),
+                       windows);
+        printWindows(windows);
+        timestamps.clear();
+        values.clear();
+    };
+
+    std::string line;
+    size_t lineNumber = 0;
+    size_t failures = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (line.empty()) {
+            continue;
+        }
+
+        const char *text = line.c_str();
+        char *end;
+        int64_t timestamp = std::strtoll(text, &end, 10);
+        auto value = sampleValue(end, options.lexer.numbers);
+        if (end == text || !value.has_value()) {
+            std::cerr << "Error (line " << lineNumber
+                      << "): Échantillon invalide, attendu '<horodatage> "
+                         "<valeur>'"
+                      << std::endl;
+            failures++;
+            continue;
+        }
+        // Hors du domaine ou fenêtre déjà passée: l'échantillon seul est
+        // écarté, les fenêtres continuent
+        try {
+            resampler.check(timestamp, *value);
+        } catch (const std::exception &e) {
+            std::cerr << "Error (line " << lineNumber << "): " << e.what()
+                      << std::endl;
+            failures++;
+            continue;
+        }
+
+        timestamps.push_back(timestamp);
+        values.push_back(*value);
+        if (timestamps.size() == BATCH_LINES) {
+            pushBlock();
+        }
+    }
+
+    pushBlock();
+    resampler.finish(windows);
+    printWindows(windows);
+    return failures;
+}
+
+/**
+ * @brief Converts the records of a shared-memory ring into another (--ring)
+ * @return 0
+ *
+ * Both rings are created by the producer side (ShmRing::create()). Records
+ * are converted until the input ring is closed and drained; the output
+ * ring is then closed too. Records of incompatible units, or with a value
+ * outside the domain of their pair, come back with from = INVALID_UNIT.
+ * With --store, results are rounded to 16-bit codes and the errors are
+ * printed on stderr.
+ */
+int convertRing(const CliOptions &options) {
+    ShmRing in = ShmRing::attach(options.ringIn);
+    ShmRing out = ShmRing::attach(options.ringOut);
+    RingConverter converter(in, out, options.store);
+    uint64_t converted = converter.run();
+    std::cerr << "Ring: " << converted << " records converted" << std::endl;
+    if (options.store.has_value()) {
+        printStoreReports(*options.store, converter.reports());
+    }
+    return 0;
 }
 
 /**
@@ -59,15 +915,75 @@ void printUsage(const char *programName) {
  */
 int main(int argc, char *argv[]) {
     // Validate command-line arguments
-    if (argc != 2) {
+    auto options = parseArguments(argc, argv);
+    if (!options.has_value()) {
         printUsage(argv[0]);
         return 1;
     }
 
+    if (!options->ringIn.empty()) {
+        try {
+            return convertRing(*options);
+        } catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Bulk mode: one request (or one sample) per line
+    if (!options->file.empty()) {
+        auto run = [&](auto convert) {
+            try {
+                return convert() == 0 ? 0 : 1;
+            } catch (const std::exception &e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+        };
+
+        // Sans cache ni rééchantillonnage: blocs lus sur le descripteur
+        if (options->cache.empty() && options->window == 0) {
+            int fd = options->file == "-"
+                         ? STDIN_FILENO
+                         : open(options->file.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                std::cerr << "Error: cannot open " << options->file
+                          << std::endl;
+                return 1;
+            }
+            int status = run([&] {
+                return options->jobs == 1 ? convertBlocks(fd, *options)
+                                          : convertParallel(fd, *options);
+            });
+            if (fd != STDIN_FILENO) {
+                close(fd);
+            }
+            return status;
+        }
+
+        auto runStream = [&](std::istream &in) {
+            return run([&] {
+                return options->window > 0 ? resampleStream(in, *options)
+                                           : convertFile(in, *options);
+            });
+        };
+        if (options->file == "-") {
+            return runStream(std::cin);
+        }
+
+        std::ifstream file(options->file);
+        if (!file) {
+            std::cerr << "Error: cannot open " << options->file << std::endl;
+            return 1;
+        }
+        return runStream(file);
+    }
+
     try {
         // Parse and convert the input
-        std::string input = argv[1];
-        Convertisseur converter(input);
+        Convertisseur converter(options->input,
+                                std::pmr::get_default_resource(),
+                                options->lexer);
         converter.convert();
         return 0;
     } catch (const std::exception &e) {
@@ -0,0 +1,737 @@
+// Module Python "convertisseur": identifiants d'unités, plans de conversion
+// et noyaux de conversion appliqués directement aux tampons de Python
+// (tableaux NumPy, array.array, memoryview) par le protocole buffer, sans
+// copie. Le GIL est relâché pendant les noyaux. Les résultats peuvent être
+// rendus en codes de 16 bits (float16, bfloat16, fixed16, voir Storage.hpp)
+// avec un rapport d'erreur.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "../include/Lexer.hpp"
+#include "../include/Parser.hpp"
+#include "../include/Plan.hpp"
+#include "../include/RequestBatch.hpp"
+#include "../include/Storage.hpp"
+#include "../include/Unit.hpp"
+#include <algorithm>
+#include <exception>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Lève une exception Python; PyErr_Format n'accepte qu'un format ASCII
+void raise(PyObject *type, const std::string &message) {
+    PyErr_SetString(type, message.c_str());
+}
+
+/// Lignes converties par lot de convert_mixed(), comme BATCH_LINES du mode
+/// fichier: les colonnes du lot restent dans le cache
+constexpr size_t BATCH_ROWS = 1024;
+
+/// Type d'un code struct, pour les messages d'erreur
+const char *typeName(char code) {
+    switch (code) {
+    case 'f':
+        return "float32";
+    case 'e':
+        return "float16";
+    case 'h':
+        return "int16";
+    default:
+        return "uint16";
+    }
+}
+
+/**
+ * @class Buffer
+ * @brief Vue sur la mémoire d'un objet Python, libérée à la destruction
+ *
+ * Seuls les tampons C-contigus sont acceptés: le noyau lit et écrit la
+ * mémoire de l'objet lui-même, une vue à pas (x[::2], x.T) est refusée
+ * plutôt que copiée.
+ */
+class Buffer {
+  public:
+    Buffer() { view.obj = nullptr; }
+    Buffer(const Buffer &) = delete;
+    Buffer &operator=(const Buffer &) = delete;
+    ~Buffer() {
+        if (view.obj != nullptr) {
+            PyBuffer_Release(&view);
+        }
+    }
+
+    /**
+     * @brief Prend la vue de obj
+     * @param formats Codes struct acceptés ("f": float32, "H": uint16,
+     *        "eH": float16 ou ses codes bruts...)
+     * @param name Nom de l'argument, pour les messages d'erreur
+     * @return false, une exception Python levée, si obj ne convient pas
+     */
+    bool get(PyObject *obj, const char *formats, bool writable,
+             const char *name) {
+        int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+        if (writable) {
+            flags |= PyBUF_WRITABLE;
+        }
+        if (PyObject_GetBuffer(obj, &view, flags) != 0) {
+            return false;
+        }
+        // Ordre natif seulement: '@', '=' ou '<' sur une machine little
+        // endian, comme les tableaux NumPy par défaut
+        const char *code = view.format != nullptr ? view.format : "B";
+        if (*code == '@' || *code == '=' ||
+            (*code == '<' && PY_LITTLE_ENDIAN) ||
+            (*code == '>' && PY_BIG_ENDIAN)) {
+            code++;
+        }
+        if (code[0] == '\0' || code[1] != '\0' ||
+            std::string_view(formats).find(code[0]) == std::string_view::npos) {
+            raise(PyExc_TypeError, std::string(name) + ": tableau de " +
+                                       typeName(formats[0]) + " attendu");
+            return false;
+        }
+        return true;
+    }
+
+    /// Nombre d'éléments
+    size_t size() const {
+        return static_cast<size_t>(view.len / view.itemsize);
+    }
+
+    template <typename T> T *data() const {
+        return static_cast<T *>(view.buf);
+    }
+
+    /// Les deux zones mémoire se chevauchent
+    bool overlaps(const Buffer &other) const {
+        auto *a = static_cast<const char *>(view.buf);
+        auto *b = static_cast<const char *>(other.view.buf);
+        return a < b + other.view.len && b < a + view.len;
+    }
+
+  private:
+    Py_buffer view;
+};
+
+/// Lève ValueError si out n'a pas expected éléments
+bool checkSize(const Buffer &out, size_t expected) {
+    if (out.size() != expected) {
+        raise(PyExc_ValueError, "out: " + std::to_string(expected) +
+                                    " éléments attendus, " +
+                                    std::to_string(out.size()) + " reçus");
+        return false;
+    }
+    return true;
+}
+
+/// Lève ValueError à la première valeur hors du domaine de la paire
+bool checkDomain(const Coefficients &c, const Buffer &values) {
+    const float *in = values.data<float>();
+    for (size_t i = 0; i < values.size(); i++) {
+        if (!inDomain(c.kind, in[i])) {
+            raise(PyExc_ValueError,
+                  "Ligne " + std::to_string(i) + ": valeur hors du domaine "
+                  "de la conversion");
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Identifiant d'une unité donnée par son nom (str) ou son identifiant (int)
+bool unitArg(PyObject *arg, UnitId &id) {
+    if (PyUnicode_Check(arg)) {
+        Py_ssize_t length = 0;
+        const char *text = PyUnicode_AsUTF8AndSize(arg, &length);
+        if (text == nullptr) {
+            return false;
+        }
+        std::string_view name(text, static_cast<size_t>(length));
+        auto found = unitId(name);
+        if (!found.has_value()) {
+            raise(PyExc_KeyError,
+                  std::string("Unité inconnue: ").append(name));
+            return false;
+        }
+        id = *found;
+        return true;
+    }
+    size_t value = PyLong_AsSize_t(arg);
+    if (value == static_cast<size_t>(-1) && PyErr_Occurred()) {
+        return false;
+    }
+    if (value >= UnitSet.size()) {
+        raise(PyExc_KeyError,
+              "Identifiant d'unité invalide: " + std::to_string(value));
+        return false;
+    }
+    id = static_cast<UnitId>(value);
+    return true;
+}
+
+/// Paire from → to, ValueError si les dimensions diffèrent
+bool pairArg(PyObject *fromArg, PyObject *toArg, PairId &pair) {
+    UnitId from = 0;
+    UnitId to = 0;
+    if (!unitArg(fromArg, from) || !unitArg(toArg, to)) {
+        return false;
+    }
+    auto found = pairId(from, to);
+    if (!found.has_value()) {
+        raise(PyExc_ValueError, std::string("Conversion impossible de ")
+                                    .append(unitName(from))
+                                    .append(" vers ")
+                                    .append(unitName(to)));
+        return false;
+    }
+    pair = *found;
+    return true;
+}
+
+/// Format de stockage demandé par le mot-clé format, nullopt pour float32
+bool formatArg(const char *name, std::optional<StorageFormat> &format) {
+    std::string_view text = name != nullptr ? name : "float32";
+    if (text == "float32") {
+        format.reset();
+    } else if (auto stored = storageFormat(text)) {
+        format = stored;
+    } else {
+        raise(PyExc_ValueError,
+              std::string("Format inconnu: ").append(text) +
+                  " (float32, float16, bfloat16 ou fixed16)");
+        return false;
+    }
+    return true;
+}
+
+/// Codes struct acceptés pour out: les codes bruts en uint16 sont acceptés
+/// pour float16, que array.array et memoryview ne savent pas créer
+const char *outFormats(std::optional<StorageFormat> format) {
+    if (!format.has_value()) {
+        return "f";
+    }
+    switch (*format) {
+    case StorageFormat::FLOAT16:
+        return "eH";
+    case StorageFormat::BFLOAT16:
+        return "H";
+    case StorageFormat::FIXED16:
+        return "h";
+    }
+    return "";
+}
+
+/// Dictionnaire Python d'un rapport de précision
+PyObject *reportDict(const PrecisionReport &report) {
+    return Py_BuildValue(
+        "{s:n,s:d,s:d,s:d,s:d,s:n}", "count",
+        static_cast<Py_ssize_t>(report.count), "step", report.step,
+        "max_abs_error", report.maxAbsError, "max_rel_error",
+        report.maxRelError, "rms_error", report.rmsError(), "overflows",
+        static_cast<Py_ssize_t>(report.overflows));
+}
+
+const char *kindName(ConversionKind kind) {
+    switch (kind) {
+    case ConversionKind::LINEAR:
+        return "linear";
+    case ConversionKind::AFFINE:
+        return "affine";
+    case ConversionKind::RECIPROCAL:
+        return "reciprocal";
+    case ConversionKind::LOGARITHMIC:
+        return "logarithmic";
+    case ConversionKind::EXPONENTIAL:
+        return "exponential";
+    }
+    return "";
+}
+
+PyObject *units(PyObject *, PyObject *) {
+    PyObject *names = PyTuple_New(static_cast<Py_ssize_t>(UnitSet.size()));
+    if (names == nullptr) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < UnitSet.size(); i++) {
+        std::string_view name = unitName(static_cast<UnitId>(i));
+        PyObject *item = PyUnicode_FromStringAndSize(
+            name.data(), static_cast<Py_ssize_t>(name.size()));
+        if (item == nullptr) {
+            Py_DECREF(names);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(names, static_cast<Py_ssize_t>(i), item);
+    }
+    return names;
+}
+
+PyObject *unitIdOf(PyObject *, PyObject *name) {
+    if (!PyUnicode_Check(name)) {
+        PyErr_SetString(PyExc_TypeError, "Nom d'unité attendu");
+        return nullptr;
+    }
+    UnitId id = 0;
+    return unitArg(name, id) ? PyLong_FromLong(id) : nullptr;
+}
+
+PyObject *unitNameOf(PyObject *, PyObject *arg) {
+    UnitId id = 0;
+    if (!PyLong_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "Identifiant d'unité attendu");
+        return nullptr;
+    }
+    if (!unitArg(arg, id)) {
+        return nullptr;
+    }
+    std::string_view name = unitName(id);
+    return PyUnicode_FromStringAndSize(name.data(),
+                                       static_cast<Py_ssize_t>(name.size()));
+}
+
+PyObject *coefficients(PyObject *, PyObject *args) {
+    PyObject *from = nullptr;
+    PyObject *to = nullptr;
+    PairId pair = 0;
+    if (!PyArg_ParseTuple(args, "OO:coefficients", &from, &to) ||
+        !pairArg(from, to, pair)) {
+        return nullptr;
+    }
+    Coefficients c = pairCoefficients(pair);
+    return Py_BuildValue("(sdd)", kindName(c.kind), c.scale, c.offset);
+}
+
+PyObject *convert(PyObject *, PyObject *args, PyObject *kwargs) {
+    static const char *keywords[] = {"values", "from_unit", "to_unit", "out",
+                                     "format", nullptr};
+    PyObject *valuesArg = nullptr;
+    PyObject *from = nullptr;
+    PyObject *to = nullptr;
+    PyObject *outArg = nullptr;
+    const char *formatName = nullptr;
+    std::optional<StorageFormat> format;
+    PairId pair = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOO|$s:convert",
+                                     const_cast<char **>(keywords),
+                                     &valuesArg, &from, &to, &outArg,
+                                     &formatName) ||
+        !formatArg(formatName, format) || !pairArg(from, to, pair)) {
+        return nullptr;
+    }
+    Buffer values;
+    Buffer out;
+    if (!values.get(valuesArg, "f", false, "values") ||
+        !out.get(outArg, outFormats(format), true, "out") ||
+        !checkSize(out, values.size())) {
+        return nullptr;
+    }
+    Coefficients c = pairCoefficients(pair);
+    if (!checkDomain(c, values)) {
+        return nullptr;
+    }
+
+    if (!format.has_value()) {
+        // Élément par élément: out peut être values lui-même, pas une vue
+        // décalée
+        if (out.data<float>() != values.data<float>() &&
+            out.overlaps(values)) {
+            PyErr_SetString(PyExc_ValueError,
+                            "out recouvre values sans lui être identique");
+            return nullptr;
+        }
+        Py_BEGIN_ALLOW_THREADS
+        applyCoefficients(c, values.data<float>(), values.size(),
+                          out.data<float>());
+        Py_END_ALLOW_THREADS
+        Py_RETURN_NONE;
+    }
+
+    if (out.overlaps(values)) {
+        PyErr_SetString(PyExc_ValueError, "out recouvre values");
+        return nullptr;
+    }
+    PrecisionReport report;
+    Py_BEGIN_ALLOW_THREADS
+    const float *in = values.data<float>();
+    size_t n = values.size();
+    if (*format == StorageFormat::FIXED16 && n > 0) {
+        // Un pas pour tout le tableau, tiré de l'étendue des résultats
+        auto [low, high] = std::minmax_element(in, in + n);
+        report.step = fixedStep(resultBound(c, *low, *high));
+    }
+    applyCoefficients(c, in, n, *format, report.step, out.data<uint16_t>(),
+                      report);
+    Py_END_ALLOW_THREADS
+    return reportDict(report);
+}
+
+PyObject *convertMixed(PyObject *, PyObject *args, PyObject *kwargs) {
+    static const char *keywords[] = {"values", "from_ids", "to_ids", "out",
+                                     "format", nullptr};
+    PyObject *valuesArg = nullptr;
+    PyObject *fromArg = nullptr;
+    PyObject *toArg = nullptr;
+    PyObject *outArg = nullptr;
+    const char *formatName = nullptr;
+    std::optional<StorageFormat> format;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOOO|$s:convert_mixed",
+                                     const_cast<char **>(keywords),
+                                     &valuesArg, &fromArg, &toArg, &outArg,
+                                     &formatName) ||
+        !formatArg(formatName, format)) {
+        return nullptr;
+    }
+    Buffer values;
+    Buffer from;
+    Buffer to;
+    Buffer out;
+    if (!values.get(valuesArg, "f", false, "values") ||
+        !from.get(fromArg, "H", false, "from_ids") ||
+        !to.get(toArg, "H", false, "to_ids") ||
+        !out.get(outArg, outFormats(format), true, "out")) {
+        return nullptr;
+    }
+    size_t n = values.size();
+    if (from.size() != n || to.size() != n) {
+        PyErr_SetString(PyExc_ValueError,
+                        "values, from_ids et to_ids de tailles différentes");
+        return nullptr;
+    }
+    if (!checkSize(out, n)) {
+        return nullptr;
+    }
+
+    // Chaque lot est copié avant d'écrire sa tranche de out: out peut être
+    // values lui-même en float32, pas une vue décalée. Les identifiants sont
+    // relus lot par lot et ne doivent pas être recouverts
+    bool inPlace = !format.has_value() &&
+                   out.data<float>() == values.data<float>();
+    if (out.overlaps(values) && !inPlace) {
+        PyErr_SetString(PyExc_ValueError,
+                        "out recouvre values sans lui être identique");
+        return nullptr;
+    }
+    if (out.overlaps(from) || out.overlaps(to)) {
+        PyErr_SetString(PyExc_ValueError, "out recouvre from_ids ou to_ids");
+        return nullptr;
+    }
+
+    // En fixed16, un seul lot: le pas de chaque unité cible vaut pour tout
+    // le tableau
+    size_t rowsPerBatch =
+        format == StorageFormat::FIXED16 ? std::max<size_t>(n, 1) : BATCH_ROWS;
+    std::vector<ColumnReport> columns;
+    std::vector<PrecisionReport> reports(UnitSet.size());
+    const UnitId *fromIds = from.data<UnitId>();
+    const UnitId *toIds = to.data<UnitId>();
+    size_t failed = n;
+    bool noMemory = false;
+    Py_BEGIN_ALLOW_THREADS
+    // Toutes les lignes sont vérifiées avant d'écrire out: une ligne
+    // invalide laisse out intact
+    for (size_t i = 0; i < n; i++) {
+        auto pair = pairId(fromIds[i], toIds[i]);
+        if (!pair.has_value() || !inDomain(pairCoefficients(*pair).kind,
+                                           values.data<float>()[i])) {
+            failed = i;
+            break;
+        }
+    }
+    try {
+        RequestBatch batch;
+        for (size_t begin = 0; begin < n && failed == n;
+             begin += rowsPerBatch) {
+            size_t end = std::min(n, begin + rowsPerBatch);
+            batch.clear();
+            for (size_t i = begin; i < end; i++) {
+                // Déjà vérifiée: ne peut pas échouer
+                (void)batch.push(values.data<float>()[i], fromIds[i],
+                                 toIds[i]);
+            }
+            if (!format.has_value()) {
+                batch.convert(out.data<float>() + begin);
+                continue;
+            }
+            batch.convert(*format, out.data<uint16_t>() + begin, columns);
+            for (const ColumnReport &column : columns) {
+                reports[column.unit].step = column.precision.step;
+                reports[column.unit].merge(column.precision);
+            }
+        }
+    } catch (const std::bad_alloc &) {
+        noMemory = true;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (noMemory) {
+        return PyErr_NoMemory();
+    }
+    if (failed != n) {
+        // Nom des unités connues, identifiant des autres
+        auto label = [](UnitId id) {
+            return id < UnitSet.size() ? std::string(unitName(id))
+                                       : std::to_string(id);
+        };
+        std::string what = pairId(fromIds[failed], toIds[failed])
+                               ? "valeur hors du domaine de la conversion"
+                               : "conversion impossible";
+        raise(PyExc_ValueError, "Ligne " + std::to_string(failed) + ": " +
+                                    what + " de " + label(fromIds[failed]) +
+                                    " vers " + label(toIds[failed]));
+        return nullptr;
+    }
+    if (!format.has_value()) {
+        Py_RETURN_NONE;
+    }
+
+    // Un rapport par unité cible présente, par nom
+    PyObject *result = PyDict_New();
+    for (size_t id = 0; result != nullptr && id < UnitSet.size(); id++) {
+        if (reports[id].count == 0) {
+            continue;
+        }
+        std::string name(unitName(static_cast<UnitId>(id)));
+        PyObject *report = reportDict(reports[id]);
+        if (report == nullptr ||
+            PyDict_SetItemString(result, name.c_str(), report) != 0) {
+            Py_CLEAR(result);
+        }
+        Py_XDECREF(report);
+    }
+    return result;
+}
+
+/// Objet Python Plan: un ConversionPlan compilé une fois
+struct PlanObject {
+    PyObject_HEAD
+    ConversionPlan *plan;
+};
+
+PyObject *planNew(PyTypeObject *type, PyObject *args, PyObject *kwargs) {
+    static const char *keywords[] = {"request", "lenient", nullptr};
+    const char *text = nullptr;
+    Py_ssize_t length = 0;
+    int lenient = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s#|p:Plan",
+                                     const_cast<char **>(keywords), &text,
+                                     &length, &lenient)) {
+        return nullptr;
+    }
+
+    ConversionPlan *plan = nullptr;
+    try {
+        LexerOptions options;
+        options.lenient = lenient != 0;
+        TokenList tokens =
+            Lexer(std::string_view(text, static_cast<size_t>(length)),
+                  std::pmr::get_default_resource(), options)
+                .lex();
+        Parser parser(tokens);
+        auto request = parser.parse();
+        if (!request.has_value()) {
+            throw std::runtime_error(
+                "Impossible de parser la requête de conversion");
+        }
+        plan = new ConversionPlan(ConversionPlan::compile(*request));
+    } catch (const std::exception &e) {
+        raise(PyExc_ValueError, e.what());
+        return nullptr;
+    }
+
+    auto *self = reinterpret_cast<PlanObject *>(type->tp_alloc(type, 0));
+    if (self == nullptr) {
+        delete plan;
+        return nullptr;
+    }
+    self->plan = plan;
+    return reinterpret_cast<PyObject *>(self);
+}
+
+void planDealloc(PyObject *object) {
+    auto *self = reinterpret_cast<PlanObject *>(object);
+    PyTypeObject *type = Py_TYPE(object);
+    delete self->plan;
+    type->tp_free(object);
+    Py_DECREF(type);
+}
+
+PyObject *planEvaluate(PyObject *object, PyObject *args) {
+    const ConversionPlan &plan = *reinterpret_cast<PlanObject *>(object)->plan;
+    PyObject *slotsArg = nullptr;
+    PyObject *outArg = nullptr;
+    if (!PyArg_ParseTuple(args, "OO:evaluate", &slotsArg, &outArg)) {
+        return nullptr;
+    }
+    Buffer slots;
+    Buffer out;
+    if (!slots.get(slotsArg, "f", false, "slots") ||
+        !out.get(outArg, "f", true, "out")) {
+        return nullptr;
+    }
+    if (slots.size() % plan.slotCount() != 0) {
+        raise(PyExc_ValueError, "slots: multiple de " +
+                                    std::to_string(plan.slotCount()) +
+                                    " éléments attendu");
+        return nullptr;
+    }
+    size_t count = slots.size() / plan.slotCount();
+    if (!checkSize(out, count * plan.targetCount())) {
+        return nullptr;
+    }
+    if (out.overlaps(slots)) {
+        PyErr_SetString(PyExc_ValueError, "out recouvre slots");
+        return nullptr;
+    }
+
+    // Une valeur hors du domaine d'une cible lève une exception, à rendre
+    // en ValueError une fois le GIL repris
+    std::string error;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        plan.evaluateBatch(slots.data<float>(), count, out.data<float>());
+    } catch (const std::exception &e) {
+        error = e.what();
+    }
+    Py_END_ALLOW_THREADS
+    if (!error.empty()) {
+        raise(PyExc_ValueError, error);
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+PyObject *planSlotCount(PyObject *object, void *) {
+    const ConversionPlan &plan = *reinterpret_cast<PlanObject *>(object)->plan;
+    return PyLong_FromSize_t(plan.slotCount());
+}
+
+PyObject *planTargets(PyObject *object, void *) {
+    const ConversionPlan &plan = *reinterpret_cast<PlanObject *>(object)->plan;
+    PyObject *names =
+        PyTuple_New(static_cast<Py_ssize_t>(plan.targetCount()));
+    if (names == nullptr) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < plan.targetCount(); i++) {
+        std::string_view name = plan.targetUnit(i);
+        PyObject *item = PyUnicode_FromStringAndSize(
+            name.data(), static_cast<Py_ssize_t>(name.size()));
+        if (item == nullptr) {
+            Py_DECREF(names);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(names, static_cast<Py_ssize_t>(i), item);
+    }
+    return names;
+}
+
+PyObject *planIsAffine(PyObject *object, void *) {
+    return PyBool_FromLong(
+        reinterpret_cast<PlanObject *>(object)->plan->isAffine());
+}
+
+PyMethodDef planMethods[] = {
+    {"evaluate", planEvaluate, METH_VARARGS,
+     "evaluate(slots, out)\n\n"
+     "Evaluates the plan for count requests. slots holds slot_count * count\n"
+     "float32, number s of request i at s * count + i (a C-contiguous array\n"
+     "of shape (slot_count, count)); out receives target_count * count\n"
+     "float32, target t of request i at t * count + i."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyGetSetDef planGetSet[] = {
+    {"slot_count", planSlotCount, nullptr,
+     "Number of numbers the plan reads per request", nullptr},
+    {"targets", planTargets, nullptr, "Target units, in output order",
+     nullptr},
+    {"is_affine", planIsAffine, nullptr,
+     "Every target is an increasing affine map of the source value",
+     nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+PyType_Slot planSlots[] = {
+    {Py_tp_new, reinterpret_cast<void *>(planNew)},
+    {Py_tp_dealloc, reinterpret_cast<void *>(planDealloc)},
+    {Py_tp_methods, planMethods},
+    {Py_tp_getset, planGetSet},
+    {Py_tp_doc, const_cast<char *>(
+                    "Plan(request, lenient=False)\n\n"
+                    "A conversion request compiled once, such as\n"
+                    "\"convert 0 kg + 0 g to lb, oz\". The numbers of the\n"
+                    "request only give its shape: evaluate() reads them\n"
+                    "from an array.")},
+    {0, nullptr}};
+
+PyType_Spec planSpec = {"convertisseur.Plan", sizeof(PlanObject), 0,
+                        Py_TPFLAGS_DEFAULT, planSlots};
+
+/// Fonction à mots-clés dans une PyMethodDef; le détour par void (*)()
+/// évite l'avertissement de conversion entre types de fonctions
+template <PyObject *(*function)(PyObject *, PyObject *, PyObject *)>
+PyCFunction withKeywords() {
+    return reinterpret_cast<PyCFunction>(
+        reinterpret_cast<void (*)()>(function));
+}
+
+PyMethodDef moduleMethods[] = {
+    {"units", units, METH_NOARGS,
+     "units()\n\nEvery unit string, indexed by unit id."},
+    {"unit_id", unitIdOf, METH_O,
+     "unit_id(name)\n\nId of a unit string; KeyError if unknown."},
+    {"unit_name", unitNameOf, METH_O,
+     "unit_name(id)\n\nUnit string of an id."},
+    {"coefficients", coefficients, METH_VARARGS,
+     "coefficients(from_unit, to_unit)\n\n"
+     "(kind, scale, offset) of a unit pair; units are names or ids."},
+    {"convert", withKeywords<convert>(),
+     METH_VARARGS | METH_KEYWORDS,
+     "convert(values, from_unit, to_unit, out, *, format='float32')\n\n"
+     "Converts float32 values into out (same size, may be values itself)\n"
+     "in place in their memory, with the GIL released. Units are names or\n"
+     "ids.\n\n"
+     "With format 'float16' (out: float16, or uint16 raw codes),\n"
+     "'bfloat16' (out: uint16 codes) or 'fixed16' (out: int16, value =\n"
+     "code * step), each result is rounded once from double into out,\n"
+     "which must not overlap values, and a dict reports count, step,\n"
+     "max_abs_error, max_rel_error, rms_error and overflows."},
+    {"convert_mixed", withKeywords<convertMixed>(),
+     METH_VARARGS | METH_KEYWORDS,
+     "convert_mixed(values, from_ids, to_ids, out, *, format='float32')\n\n"
+     "Converts rows of any unit pairs: float32 values, uint16 unit ids.\n"
+     "Rows are grouped by unit pair and each pair goes through its kernel\n"
+     "once per block, with the GIL released.\n\n"
+     "With a 16-bit format (see convert()), returns a dict of reports by\n"
+     "target unit name; in fixed16, each target unit has its own step."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyModuleDef moduleDef = {PyModuleDef_HEAD_INIT,
+                         "convertisseur",
+                         "Unit conversion kernels on buffers (NumPy arrays,\n"
+                         "array.array, memoryview), without copies.",
+                         -1,
+                         moduleMethods,
+                         nullptr,
+                         nullptr,
+                         nullptr,
+                         nullptr};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_convertisseur() {
+    PyObject *module = PyModule_Create(&moduleDef);
+    if (module == nullptr) {
+        return nullptr;
+    }
+    PyObject *planType = PyType_FromSpec(&planSpec);
+    if (planType == nullptr ||
+        PyModule_AddObject(module, "Plan", planType) != 0) {
+        Py_XDECREF(planType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,406 @@
+#include "../include/AsyncIO.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define CONVERTISSEUR_IO_URING 1
+#endif
+
+namespace {
+
+/// Étiquette de la complétion de l'écriture; les lectures portent le
+/// numéro de leur tampon
+constexpr uint64_t WRITE_TAG = ~uint64_t(0);
+
+[[noreturn]] void fail(const char *what, int error) {
+    throw std::runtime_error(std::string(what) + ": " + std::strerror(error));
+}
+
+#ifdef CONVERTISSEUR_IO_URING
+// Appels système bruts: pas de dépendance à liburing
+int ioUringSetup(unsigned entries, io_uring_params *params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned submit, unsigned wait, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, wait,
+                                    flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void *arg,
+                    unsigned count) {
+    return static_cast<int>(
+        syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+#endif
+
+} // namespace
+
+AsyncIO::AsyncIO(int in, int out, bool ring, size_t blockBytes,
+                 unsigned depth)
+    : in(in), out(out), blockBytes(blockBytes), depth(std::max(depth, 1u)),
+      memory(new char[(this->depth + 2) * blockBytes]),
+      slots(this->depth, Slot::FREE), lengths(this->depth, 0),
+      blocks(this->depth, 0), filling(this->depth) {
+    struct stat info;
+    seekable = fstat(in, &info) == 0 && S_ISREG(info.st_mode);
+    inBase = seekable ? lseek(in, 0, SEEK_CUR) : -1;
+    if (inBase < 0) {
+        seekable = false;
+    }
+    setp(buffer(filling), buffer(filling) + blockBytes);
+
+    if (ring && !setupRing()) {
+        ringFd = -1;
+    }
+}
+
+AsyncIO::~AsyncIO() {
+    try {
+        finish();
+    } catch (const std::exception &) {
+        // Erreur déjà signalée par finish() si l'appelant l'a appelé
+    }
+#ifdef CONVERTISSEUR_IO_URING
+    if (ringFd >= 0) {
+        // Le noyau écrit encore dans les tampons des opérations en vol
+        while (reading > 0 || writing) {
+            unsigned before = reading + (writing ? 1 : 0);
+            try {
+                submit(1);
+            } catch (const std::exception &) {
+                if (reading + (writing ? 1u : 0u) == before) {
+                    break;
+                }
+            }
+        }
+        munmap(entries, entriesBytes);
+        if (cqRing != sqRing) {
+            munmap(cqRing, cqRingBytes);
+        }
+        munmap(sqRing, sqRingBytes);
+        close(ringFd);
+    }
+#endif
+}
+
+bool AsyncIO::setupRing() {
+#ifdef CONVERTISSEUR_IO_URING
+    // depth lectures et une écriture au plus en vol
+    io_uring_params params{};
+    ringFd = ioUringSetup(depth + 2, &params);
+    if (ringFd < 0) {
+        return false;
+    }
+    // Lectures et écritures à la position courante (offset -1) pour les
+    // tubes: Linux 5.6, comme IORING_OP_READ et IORING_OP_WRITE
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+        close(ringFd);
+        return false;
+    }
+
+    sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingBytes =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) {
+        sqRingBytes = cqRingBytes = std::max(sqRingBytes, cqRingBytes);
+    }
+    sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        close(ringFd);
+        return false;
+    }
+    cqRing = single ? sqRing
+                    : mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, ringFd,
+                           IORING_OFF_CQ_RING);
+    entriesBytes = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, entriesBytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (cqRing == MAP_FAILED || sqes == MAP_FAILED) {
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            munmap(cqRing, cqRingBytes);
+        }
+        munmap(sqRing, sqRingBytes);
+        close(ringFd);
+        return false;
+    }
+    entries = static_cast<io_uring_sqe *>(sqes);
+
+    auto *sq = static_cast<char *>(sqRing);
+    auto *cq = static_cast<char *>(cqRing);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    completions = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    // Tampons enregistrés: le noyau les épingle une fois pour toutes au
+    // lieu de le faire à chaque opération. Sans (limite RLIMIT_MEMLOCK),
+    // lectures et écritures ordinaires
+    std::vector<iovec> buffers(depth + 2);
+    for (size_t i = 0; i < buffers.size(); i++) {
+        buffers[i] = iovec{buffer(i), blockBytes};
+    }
+    fixed = ioUringRegister(ringFd, IORING_REGISTER_BUFFERS, buffers.data(),
+                            static_cast<unsigned>(buffers.size())) == 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+io_uring_sqe *AsyncIO::nextEntry() {
+#ifdef CONVERTISSEUR_IO_URING
+    // Seul ce processus écrit la queue de soumission: lecture simple
+    unsigned tail = *sqTail;
+    unsigned index = tail & *sqMask;
+    io_uring_sqe *entry = &entries[index];
+    std::memset(entry, 0, sizeof *entry);
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    queued++;
+    return entry;
+#else
+    return nullptr;
+#endif
+}
+
+void AsyncIO::queueRead(size_t slot) {
+#ifdef CONVERTISSEUR_IO_URING
+    io_uring_sqe *entry = nextEntry();
+    size_t filled = lengths[slot];
+    entry->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    entry->fd = in;
+    entry->addr = reinterpret_cast<uint64_t>(buffer(slot) + filled);
+    entry->len = static_cast<uint32_t>(blockBytes - filled);
+    entry->off = seekable ? static_cast<uint64_t>(inBase) +
+                                blocks[slot] * blockBytes + filled
+                          : ~uint64_t(0);
+    entry->buf_index = static_cast<uint16_t>(slot);
+    entry->user_data = slot;
+    reading++;
+#else
+    (void)slot;
+#endif
+}
+
+void AsyncIO::queueWrite() {
+#ifdef CONVERTISSEUR_IO_URING
+    io_uring_sqe *entry = nextEntry();
+    size_t index = filling == depth ? depth + 1 : depth;
+    entry->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    entry->fd = out;
+    entry->addr = reinterpret_cast<uint64_t>(buffer(index) + written);
+    entry->len = static_cast<uint32_t>(writeLength - written);
+    entry->off = ~uint64_t(0);
+    entry->buf_index = static_cast<uint16_t>(index);
+    entry->user_data = WRITE_TAG;
+    writing = true;
+#endif
+}
+
+void AsyncIO::submit(unsigned wait) {
+#ifdef CONVERTISSEUR_IO_URING
+    if (queued > 0 || wait > 0) {
+        int submitted = ioUringEnter(ringFd, queued, wait,
+                                     wait > 0 ? IORING_ENTER_GETEVENTS : 0);
+        if (submitted < 0) {
+            if (errno == EINTR) {
+                return;
+            }
+            fail("io_uring_enter", errno);
+        }
+        queued -= static_cast<unsigned>(submitted);
+    }
+
+    unsigned head = *cqHead;
+    unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        const io_uring_cqe &cqe = completions[head & *cqMask];
+        complete(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+    if (failure != 0) {
+        int error = failure;
+        failure = 0;
+        fail("Erreur d'entrée/sortie", error);
+    }
+#else
+    (void)wait;
+#endif
+}
+
+void AsyncIO::complete(uint64_t tag, int result) {
+    bool retry = result == -EINTR || result == -EAGAIN;
+    if (tag == WRITE_TAG) {
+        writing = false;
+        if (result < 0 && !retry) {
+            failure = -result;
+            return;
+        }
+        // Écriture partielle: le reste est soumis à nouveau
+        written += retry ? 0 : static_cast<size_t>(result);
+        if (written < writeLength) {
+            queueWrite();
+        }
+        return;
+    }
+
+    size_t slot = tag;
+    reading--;
+    if (retry) {
+        queueRead(slot);
+        return;
+    }
+    if (result < 0) {
+        failure = -result;
+        slots[slot] = Slot::READY;
+        return;
+    }
+    if (result == 0) {
+        endOfInput = true;
+        slots[slot] = Slot::READY;
+        return;
+    }
+    lengths[slot] += static_cast<size_t>(result);
+    // Lecture partielle d'un fichier: le reste du bloc est redemandé, pour
+    // que le bloc suivant commence bien à son offset
+    if (seekable && lengths[slot] < blockBytes) {
+        queueRead(slot);
+        return;
+    }
+    slots[slot] = Slot::READY;
+}
+
+void AsyncIO::refill() {
+    // Un tube se lit dans l'ordre: une seule lecture en vol
+    while (!endOfInput && requested < delivered + depth &&
+           (seekable || reading == 0)) {
+        size_t slot = requested % depth;
+        if (slots[slot] != Slot::FREE) {
+            break;
+        }
+        slots[slot] = Slot::READING;
+        lengths[slot] = 0;
+        blocks[slot] = requested++;
+        queueRead(slot);
+    }
+}
+
+bool AsyncIO::read(std::string_view &block) {
+    if (holding) {
+        slots[(delivered - 1) % depth] = Slot::FREE;
+        holding = false;
+    }
+
+    if (ringFd < 0) {
+        ssize_t n;
+        do {
+            n = ::read(in, buffer(0), blockBytes);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0) {
+            fail("Erreur de lecture", errno);
+        }
+        block = std::string_view(buffer(0), static_cast<size_t>(n));
+        return n > 0;
+    }
+
+    refill();
+    size_t slot = delivered % depth;
+    if (delivered == requested && slots[slot] == Slot::FREE) {
+        // Fin atteinte et plus rien en vol
+        submit(0);
+        return false;
+    }
+    submit(0);
+    while (slots[slot] != Slot::READY) {
+        submit(1);
+        // Une lecture de tube terminée libère la suivante
+        refill();
+    }
+    if (lengths[slot] == 0) {
+        return false;
+    }
+    block = std::string_view(buffer(slot), lengths[slot]);
+    holding = true;
+    delivered++;
+    refill();
+    return true;
+}
+
+void AsyncIO::flushBuffer() {
+    size_t length = static_cast<size_t>(pptr() - pbase());
+    if (length == 0) {
+        return;
+    }
+    if (ringFd < 0) {
+        const char *data = pbase();
+        while (length > 0) {
+            ssize_t n = ::write(out, data, length);
+            if (n < 0 && errno != EINTR) {
+                fail("Erreur d'écriture", errno);
+            }
+            data += n > 0 ? n : 0;
+            length -= n > 0 ? static_cast<size_t>(n) : 0;
+        }
+        setp(pbase(), epptr());
+        return;
+    }
+
+    // Le tampon précédent doit être écrit avant d'être rempli à nouveau
+    while (writing) {
+        submit(1);
+    }
+    written = 0;
+    writeLength = length;
+    filling = filling == depth ? depth + 1 : depth;
+    queueWrite();
+    setp(buffer(filling), buffer(filling) + blockBytes);
+}
+
+int AsyncIO::overflow(int c) {
+    flushBuffer();
+    if (c != traits_type::eof()) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize AsyncIO::xsputn(const char *s, std::streamsize n) {
+    std::streamsize left = n;
+    while (left > 0) {
+        if (pptr() == epptr()) {
+            flushBuffer();
+        }
+        std::streamsize room =
+            std::min<std::streamsize>(left, epptr() - pptr());
+        std::memcpy(pptr(), s, static_cast<size_t>(room));
+        pbump(static_cast<int>(room));
+        s += room;
+        left -= room;
+    }
+    return n;
+}
+
+void AsyncIO::finish() {
+    flushBuffer();
+    while (writing || queued > 0) {
+        submit(writing ? 1 : 0);
+    }
+}
@@ -1,217 +1,165 @@
 #include "../include/Convertisseur.hpp"
+#include "../include/ByteClass.hpp"
 #include "../include/Unit.hpp"
+#include "../include/UnitIndex.hpp"
 #include <iostream>
 #include <stdexcept>
 
 // Constructeur: lexe et parse la chaîne d'entrée
-Convertisseur::Convertisseur(const std::string &input) {
-    // Lexical analysis
-    Lexer lexer(input);
-    std::vector<Token> tokens = lexer.lex();
-
-    // Parsing
-    Parser parser(tokens);
-    auto conversionRequest = parser.parse();
+Convertisseur::Convertisseur(std::string_view input,
+                             std::pmr::memory_resource *mr,
+                             LexerOptions options)
+    : tokens(Lexer(input, mr, options).lex()),
+      cr{0.0f, std::pmr::string(mr), std::pmr::string(mr),
+         std::pmr::vector<ExprNode>(mr),
+         std::pmr::vector<std::pmr::string>(mr)} {
+    parse();
+}
 
-    if (!conversionRequest.has_value()) {
-        throw std::runtime_error(
-            "Erreur: Impossible de parser la requête de conversion");
-    }
+// Constructeur avec cache: seules les formes inédites sont parsées
+Convertisseur::Convertisseur(std::string_view input, PlanCache &plans,
+                             std::pmr::memory_resource *mr,
+                             LexerOptions options)
+    : tokens(Lexer(input, mr, options).lex()),
+      cr{0.0f, std::pmr::string(mr), std::pmr::string(mr),
+         std::pmr::vector<ExprNode>(mr),
+         std::pmr::vector<std::pmr::string>(mr)} {
+    lookupPlan(plans);
+}
 
-    cr = conversionRequest.value();
+// Constructeur depuis des tokens déjà lexés (StreamLexer)
+Convertisseur::Convertisseur(TokenList lexed, PlanCache &plans)
+    : tokens(std::move(lexed)),
+      cr{0.0f, std::pmr::string(tokens.get_allocator().resource()),
+         std::pmr::string(tokens.get_allocator().resource()),
+         std::pmr::vector<ExprNode>(tokens.get_allocator().resource()),
+         std::pmr::vector<std::pmr::string>(
+             tokens.get_allocator().resource())} {
+    lookupPlan(plans);
 }
 
-// Fonction principale de conversion
-float Convertisseur::convert() {
-    // Vérifier que les deux unités existent
-    if (UnitSet.find(cr.fromUnit) == UnitSet.end()) {
-        throw std::runtime_error("Unité source invalide: " + cr.fromUnit);
-    }
-    if (UnitSet.find(cr.toUnit) == UnitSet.end()) {
-        throw std::runtime_error("Unité cible invalide: " + cr.toUnit);
+void Convertisseur::lookupPlan(PlanCache &plans) {
+    plan = plans.find(tokens);
+    if (plan == nullptr) {
+        parse();
+        plan = &plans.insert(tokens, ConversionPlan::compile(cr));
     }
+}
 
-    UnitType sourceType = UnitSet[cr.fromUnit];
-    UnitType targetType = UnitSet[cr.toUnit];
+// Parse les tokens; la requête est allouée depuis la même ressource
+void Convertisseur::parse() {
+    Parser parser(tokens, tokens.get_allocator().resource());
+    auto conversionRequest = parser.parse();
 
-    // Vérifier que les deux unités sont de la même dimension
-    if (sourceType != targetType) {
-        throw std::runtime_error("Impossible de convertir " + cr.fromUnit +
-                                 " en " + cr.toUnit +
-                                 " : dimensions incompatibles");
-    }
-    float result = 0.0f;
-
-    switch (sourceType) {
-    case UnitType::WEIGHT:
-        result = convertWeight();
-        break;
-    case UnitType::DISTANCE:
-        result = convertDistance();
-        break;
-    case UnitType::VOLUME:
-        result = convertVolume();
-        break;
-    case UnitType::TIME:
-        result = convertTime();
-        break;
-    case UnitType::TEMPERATURE:
-        result = convertTemperatur();
-        break;
-    case UnitType::AREA:
-        result = convertArea();
-        break;
-    case UnitType::SPEED:
-        result = convertSpeed();
-        break;
-    case UnitType::PRESSURE:
-        result = convertPressure();
-        break;
-    default:
-        throw std::runtime_error("Type d'unité non supporté");
+    if (!conversionRequest.has_value()) {
+        throw std::runtime_error(
+            "Erreur: Impossible de parser la requête de conversion" +
+            unknownUnitHint(tokens));
     }
 
-    std::cout << cr.value << " " << cr.fromUnit << " = " << result << " "
-              << cr.toUnit << std::endl;
-
-    return result;
+    // Même allocateur des deux côtés: le move ne copie rien
+    cr = std::move(*conversionRequest);
 }
 
-// Conversion de poids (en kg comme unité de base)
-float Convertisseur::convertWeight() {
-    // Tableaux de conversion vers kg
-    std::unordered_map<std::string, float> toKg = {
-        {"kg", 1.0f},       {"g", 0.001f},
-        {"mg", 0.000001f},  {"t", 1000.0f}, // tonne métrique
-        {"ton", 1000.0f},                   // tonne métrique
-        {"lb", 0.453592f},                  // pound
-        {"oz", 0.0283495f},                 // ounce
-        {"st", 6.35029f},                   // stone
-        {"ct", 0.0002f}                     // carat
-    };
-
-    float valueInKg = cr.value * toKg[cr.fromUnit];
-    return valueInKg / toKg[cr.toUnit];
+// Suggestions pour le premier mot inconnu: "(unité inconnue 'kpa',
+// vouliez-vous dire 'kPa' ?)"
+std::string Convertisseur::unknownUnitHint(const TokenList &tokens) {
+    for (const Token &token : tokens) {
+        // Un mot: lettre ASCII ou début de caractère UTF-8 (°, μ...)
+        char first = token.value.empty() ? '\0' : token.value[0];
+        if (token.type != TokenType::UNKNOWN ||
+            (byteClass(first) & (ByteClass::ALPHA | ByteClass::UTF8_LEAD)) ==
+                0) {
+            continue;
+        }
+
+        std::string hint =
+            std::string(" (unité inconnue '").append(token.value).append("'");
+
+        const UnitIndex &index = UnitIndex::global();
+        std::vector<std::string_view> suggestions;
+        if (auto unit = index.resolve(token.value)) {
+            suggestions.push_back(*unit);
+        } else {
+            suggestions = index.suggest(token.value);
+        }
+
+        for (size_t i = 0; i < suggestions.size(); i++) {
+            hint.append(i == 0 ? ", vouliez-vous dire '" : " ou '")
+                .append(suggestions[i])
+                .append("'");
+        }
+        return hint.append(suggestions.empty() ? ")" : " ?)");
+    }
+    return "";
 }
 
-// Conversion de distance (en mètre comme unité de base)
-float Convertisseur::convertDistance() {
-    std::unordered_map<std::string, float> toM = {
-        {"m", 1.0f},          {"km", 1000.0f},   {"cm", 0.01f},
-        {"mm", 0.001f},       {"μm", 0.000001f}, // micromètre
-        {"nm", 0.000000001f},                    // nanomètre
-        {"mi", 1609.34f},                        // mile
-        {"yd", 0.9144f},                         // yard
-        {"ft", 0.3048f},                         // foot
-        {"in", 0.0254f},                         // inch
-        {"nmi", 1852.0f}                         // nautical mile
-    };
-
-    float valueInM = cr.value * toM[cr.fromUnit];
-    return valueInM / toM[cr.toUnit];
+// Affiche l'expression source entre "convert" et "to"
+void Convertisseur::printSource(std::ostream &out, const float *slots) const {
+    size_t slot = 0;
+    bool first = true;
+    bool glue = false; // pas d'espace après '(' ou un '-' unaire
+
+    for (size_t i = 1; i < tokens.size(); i++) {
+        const Token &token = tokens[i];
+        if (token.type == TokenType::KEYWORD) {
+            break;
+        }
+
+        bool isOperator = token.type == TokenType::OPERATOR;
+        if (!first && !glue && !(isOperator && token.value == ")")) {
+            out << ' ';
+        }
+
+        if (token.type == TokenType::DECIMAL) {
+            out << slots[slot++];
+        } else {
+            out << token.value;
+        }
+
+        // '-' unaire: en tête ou après un opérateur autre que ')'
+        const Token &previous = tokens[i - 1];
+        bool afterOperand = !first && (previous.type != TokenType::OPERATOR ||
+                                       previous.value == ")");
+        glue = isOperator &&
+               (token.value == "(" || (token.value == "-" && !afterOperand));
+        first = false;
+    }
 }
 
-// Conversion de volume (en litre comme unité de base)
-float Convertisseur::convertVolume() {
-    std::unordered_map<std::string, float> toL = {
-        {"L", 1.0f},          {"l", 1.0f},           {"mL", 0.001f},
-        {"ml", 0.001f},       {"cL", 0.01f},         {"cl", 0.01f},
-        {"dL", 0.1f},         {"dl", 0.1f},          {"m³", 1000.0f},
-        {"m3", 1000.0f},      {"cm³", 0.001f},       {"cm3", 0.001f},
-        {"gal", 3.78541f},                           // gallon US
-        {"qt", 0.946353f},                           // quart
-        {"pt", 0.473176f},                           // pint
-        {"cup", 0.236588f},   {"fl oz", 0.0295735f}, // fluid ounce
-        {"tbsp", 0.0147868f},                        // tablespoon
-        {"tsp", 0.00492892f}                         // teaspoon
-    };
-
-    float valueInL = cr.value * toL[cr.fromUnit];
-    return valueInL / toL[cr.toUnit];
+// Plan de la requête; sans cache, il est compilé à la première conversion
+const ConversionPlan &Convertisseur::compiledPlan() {
+    if (plan == nullptr) {
+        ownPlan = ConversionPlan::compile(cr);
+        plan = &*ownPlan;
+    }
+    return *plan;
 }
 
-// Conversion de temps (en secondes comme unité de base)
-float Convertisseur::convertTime() {
-    std::unordered_map<std::string, float> toS = {
-        {"s", 1.0f},           {"ms", 0.001f},    {"μs", 0.000001f},
-        {"ns", 0.000000001f},  {"min", 60.0f},    {"h", 3600.0f},
-        {"hr", 3600.0f},       {"day", 86400.0f}, {"week", 604800.0f},
-        {"month", 2592000.0f}, // 30 jours
-        {"year", 31536000.0f}, // 365 jours
-        {"yr", 31536000.0f}    // 365 jours
-    };
-
-    float valueInS = cr.value * toS[cr.fromUnit];
-    return valueInS / toS[cr.toUnit];
+// Fonction principale de conversion
+float Convertisseur::convert(std::ostream &out) {
+    return convertAll(out).front();
 }
 
-// Conversion de température
-float Convertisseur::convertTemperatur() {
-    std::string fromUnit = cr.fromUnit;
-    std::string toUnit = cr.toUnit;
-
-    // Normaliser les unités (enlever les accents/symboles)
-    if (fromUnit == "°C")
-        fromUnit = "C";
-    if (toUnit == "°C")
-        toUnit = "C";
-    if (fromUnit == "°F")
-        fromUnit = "F";
-    if (toUnit == "°F")
-        toUnit = "F";
-
-    float tempInCelsius = cr.value;
-
-    // Convertir en Celsius d'abord
-    if (fromUnit == "F") {
-        tempInCelsius = (cr.value - 32.0f) * 5.0f / 9.0f;
-    } else if (fromUnit == "K") {
-        tempInCelsius = cr.value - 273.15f;
-    }
-    // Si déjà en Celsius, ne rien faire
+float Convertisseur::convert() { return convert(std::cout); }
 
-    // Convertir depuis Celsius vers l'unité cible
-    if (toUnit == "F") {
-        return (tempInCelsius * 9.0f / 5.0f) + 32.0f;
-    } else if (toUnit == "K") {
-        return tempInCelsius + 273.15f;
-    }
-    // Si cible est Celsius, retourner directement
-    return tempInCelsius;
-}
-
-// Conversion d'aire/surface (en m² comme unité de base)
-float Convertisseur::convertArea() {
-    std::unordered_map<std::string, float> toM2 = {
-        {"m²", 1.0f},        {"m2", 1.0f},       {"km²", 1000000.0f},
-        {"km2", 1000000.0f}, {"cm²", 0.0001f},   {"cm2", 0.0001f},
-        {"mm²", 0.000001f},  {"mm2", 0.000001f}, {"ha", 10000.0f}, // hectare
-        {"acre", 4046.86f},  {"ft²", 0.092903f}, {"ft2", 0.092903f},
-        {"yd²", 0.836127f},  {"yd2", 0.836127f}};
-
-    float valueInM2 = cr.value * toM2[cr.fromUnit];
-    return valueInM2 / toM2[cr.toUnit];
-}
+std::vector<float> Convertisseur::convertAll() { return convertAll(std::cout); }
 
-// Conversion de vitesse (en m/s comme unité de base)
-float Convertisseur::convertSpeed() {
-    std::unordered_map<std::string, float> toMS = {
-        {"m/s", 1.0f},     {"km/h", 0.277778f},
-        {"mph", 0.44704f}, // miles per hour
-        {"ft/s", 0.3048f}, {"knot", 0.51444f},
-        {"kn", 0.51444f}};
+// Conversion vers toutes les unités cibles: "100 km/h = 27.7778 m/s =
+// 62.1371 mph"
+std::vector<float> Convertisseur::convertAll(std::ostream &out) {
+    const ConversionPlan &compiled = compiledPlan();
 
-    float valueInMS = cr.value * toMS[cr.fromUnit];
-    return valueInMS / toMS[cr.toUnit];
-}
+    float slots[ConversionPlan::MAX_SLOTS];
+    readSlots(tokens, slots);
+    std::vector<float> results(compiled.targetCount());
+    compiled.evaluateAll(slots, results.data());
 
-// Conversion de pression (en Pascal comme unité de base)
-float Convertisseur::convertPressure() {
-    std::unordered_map<std::string, float> toPa = {
-        {"Pa", 1.0f},       {"kPa", 1000.0f},   {"MPa", 1000000.0f},
-        {"bar", 100000.0f}, {"mbar", 100.0f},   {"psi", 6894.76f},
-        {"atm", 101325.0f}, {"mmHg", 133.322f}, {"inHg", 3386.39f}};
+    printSource(out, slots);
+    for (size_t i = 0; i < results.size(); i++) {
+        out << " = " << results[i] << " " << compiled.targetUnit(i);
+    }
+    out << std::endl;
 
-    float valueInPa = cr.value * toPa[cr.fromUnit];
-    return valueInPa / toPa[cr.toUnit];
+    return results;
 }
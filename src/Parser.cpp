@@ -1,14 +1,17 @@
 #include "../include/Parser.hpp"
+#include "../include/Plan.hpp"
+#include <algorithm>
 
 // Exception ParseError
 ParseError::ParseError(const std::string &message)
     : std::runtime_error(message) {}
 
 // Constructeur
-Parser::Parser(const std::vector<Token> &tokens) : tokens(tokens), idx(0) {}
+Parser::Parser(const TokenList &tokens, std::pmr::memory_resource *mr)
+    : tokens(tokens), idx(0), mr(mr), expression(mr) {}
 
 // Récupère le token actuel sans avancer
-Token Parser::peek() {
+const Token &Parser::peek() {
     if (isAtEnd()) {
         throw ParseError("Unexpected end of tokens");
     }
@@ -16,13 +19,22 @@ Token Parser::peek() {
 }
 
 // Récupère le token actuel et avance
-Token Parser::consume() {
+const Token &Parser::consume() {
     if (isAtEnd()) {
         throw ParseError("Unexpected end of tokens");
     }
     return tokens[idx++];
 }
 
+// Un niveau d'imbrication de plus; au-delà de MAX_DEPTH, la requête serait
+// refusée à la compilation et la récursion pourrait épuiser la pile
+Parser::Nesting::Nesting(Parser &parser) : depth(parser.depth) {
+    if (depth == ConversionPlan::MAX_DEPTH) {
+        throw ParseError("Expression nested too deeply");
+    }
+    depth++;
+}
+
 // Vérifie si on a atteint la fin des tokens
 bool Parser::isAtEnd() { return idx == tokens.size(); }
 
@@ -36,23 +48,130 @@ void Parser::expect(TokenType type, const std::string &errorMessage) {
     }
 }
 
+// Vérifie si le token actuel est l'opérateur op
+bool Parser::isOperator(char op) {
+    return !isAtEnd() && peek().type == TokenType::OPERATOR &&
+           peek().value[0] == op;
+}
+
+// Ajoute un noeud d'opération à l'expression
+void Parser::emit(ExprNode::Kind kind) {
+    expression.push_back(ExprNode{kind, 0.0f, std::pmr::string(mr)});
+}
+
+// Ajoute un noeud NUMBER pour le DECIMAL courant
+void Parser::parseNumber() {
+    expect(TokenType::DECIMAL, "Expected decimal number");
+    auto value = decimalValue(consume().value);
+    if (!value.has_value()) {
+        throw ParseError("Decimal number out of range");
+    }
+    expression.push_back(
+        ExprNode{ExprNode::Kind::NUMBER, *value, std::pmr::string(mr)});
+}
+
+// sum → product (("+" | "-") product)*
+void Parser::parseSum() {
+    parseProduct();
+    while (isOperator('+') || isOperator('-')) {
+        auto kind = consume().value[0] == '+' ? ExprNode::Kind::ADD
+                                               : ExprNode::Kind::SUB;
+        parseProduct();
+        emit(kind);
+    }
+}
+
+// product → unary (("*" | "/") unary)*
+void Parser::parseProduct() {
+    parseUnary();
+    while (isOperator('*') || isOperator('/')) {
+        auto kind = consume().value[0] == '*' ? ExprNode::Kind::MUL
+                                               : ExprNode::Kind::DIV;
+        parseUnary();
+        emit(kind);
+    }
+}
+
+// unary → "-" unary | quantity
+void Parser::parseUnary() {
+    if (isOperator('-')) {
+        consume();
+        Nesting nesting(*this);
+        parseUnary();
+        emit(ExprNode::Kind::NEG);
+        return;
+    }
+    parseQuantity();
+}
+
+// quantity → primary (DECIMAL UNIT)*
+// Les quantités juxtaposées s'additionnent: "5 ft 11 in" = 5 ft + 11 in
+void Parser::parseQuantity() {
+    bool hasUnit = parsePrimary();
+    while (hasUnit && !isAtEnd() && peek().type == TokenType::DECIMAL) {
+        parseNumber();
+        expect(TokenType::UNIT, "Expected unit");
+        expression.push_back(ExprNode{ExprNode::Kind::UNIT, 0.0f,
+                                      std::pmr::string(consume().value, mr)});
+        emit(ExprNode::Kind::ADD);
+    }
+}
+
+// primary → DECIMAL UNIT? | "(" sum ")" UNIT?
+bool Parser::parsePrimary() {
+    if (isOperator('(')) {
+        consume();
+        Nesting nesting(*this);
+        parseSum();
+        if (!isOperator(')')) {
+            throw ParseError("Expected ')'");
+        }
+        consume();
+    } else {
+        parseNumber();
+    }
+
+    if (isAtEnd() || peek().type != TokenType::UNIT) {
+        return false;
+    }
+    expression.push_back(ExprNode{ExprNode::Kind::UNIT, 0.0f,
+                                  std::pmr::string(consume().value, mr)});
+    return true;
+}
+
 // Parse les tokens et retourne une ConversionRequest
-// Structure attendue: convert <DECIMAL> <UNIT> to <UNIT>
+// Structure attendue: convert <expression> to <UNIT>[, <UNIT>...]
 [[nodiscard]] std::optional<ConversionRequest> Parser::parse() {
     try {
+        expression.clear();
+        depth = 0;
+
         // Expect "convert" keyword
         expect(TokenType::KEYWORD, "Expected 'convert' keyword");
         if (consume().value != "convert") {
             throw ParseError("Expected 'convert' keyword");
         }
+        bool leadingMinus = isOperator('-');
 
-        // Expect decimal number
-        expect(TokenType::DECIMAL, "Expected decimal number");
-        float value = std::stof(consume().value);
+        // Expect source expression
+        parseSum();
 
-        // Expect source unit
-        expect(TokenType::UNIT, "Expected unit");
-        std::string fromUnit = consume().value;
+        // La première quantité donne value et fromUnit
+        auto unit = std::find_if(
+            expression.begin(), expression.end(),
+            [](const ExprNode &n) { return n.kind == ExprNode::Kind::UNIT; });
+        if (unit == expression.end()) {
+            throw ParseError("Expected unit");
+        }
+        float value = 0.0f;
+        if (unit != expression.begin() &&
+            (unit - 1)->kind == ExprNode::Kind::NUMBER) {
+            value = (unit - 1)->value;
+            if (leadingMinus && unit - 1 == expression.begin()) {
+                value = -value;
+            }
+        }
+        std::pmr::string fromUnit(unit->unit, mr);
 
         // Expect "to" keyword
         expect(TokenType::KEYWORD, "Expected 'to' keyword");
@@ -60,16 +179,26 @@ void Parser::expect(TokenType type, const std::string &errorMessage) {
             throw ParseError("Expected 'to' keyword");
         }
 
-        // Expect target unit
-        expect(TokenType::UNIT, "Expected target unit");
-        std::string toUnit = consume().value;
+        // Expect target units, separated by ','
+        std::pmr::vector<std::pmr::string> toUnits(mr);
+        do {
+            if (!toUnits.empty()) {
+                consume();
+            }
+            expect(TokenType::UNIT, "Expected target unit");
+            // La chaîne reçoit l'allocateur du vecteur (mr)
+            toUnits.emplace_back(consume().value);
+        } while (!isAtEnd() && peek().type == TokenType::SEPARATOR);
+        std::pmr::string toUnit(toUnits.front(), mr);
 
         // Should be at end
         if (!isAtEnd()) {
             throw ParseError("Unexpected tokens after conversion request");
         }
 
-        return ConversionRequest{value, fromUnit, toUnit};
+        return ConversionRequest{value, std::move(fromUnit),
+                                 std::move(toUnit), std::move(expression),
+                                 std::move(toUnits)};
     } catch (const ParseError &) {
         return std::nullopt;
     }
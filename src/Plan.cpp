@@ -0,0 +1,558 @@
+#include "../include/Plan.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+// Type d'une valeur de la pile pendant la compilation
+struct Value {
+    bool quantity;         // false: nombre sans unité
+    UnitType type;         // dimension d'une quantité
+    std::string_view unit; // unité représentative (messages d'erreur)
+};
+
+std::string describe(const Value &v) {
+    return v.quantity ? std::string(v.unit) : std::string("un nombre");
+}
+
+} // namespace
+
+void ConversionPlan::emit(Op::Code code, double factor, uint32_t slot) {
+    ops.push_back(Op{code, slot, factor});
+}
+
+// Unités cibles de la requête ("to km, mi"); une requête construite à la
+// main peut n'avoir que toUnit
+static std::vector<std::pair<std::string_view, UnitType>>
+targetsOf(const ConversionRequest &request) {
+    std::vector<std::string_view> names(request.toUnits.begin(),
+                                        request.toUnits.end());
+    if (names.empty()) {
+        names.emplace_back(request.toUnit);
+    }
+    if (names.size() > ConversionPlan::MAX_TARGETS) {
+        throw std::runtime_error("Trop d'unités cibles");
+    }
+
+    std::vector<std::pair<std::string_view, UnitType>> targets;
+    targets.reserve(names.size());
+    for (std::string_view name : names) {
+        auto target = UnitSet.find(name);
+        if (target == UnitSet.end()) {
+            throw std::runtime_error(
+                std::string("Unité cible invalide: ").append(name));
+        }
+        targets.emplace_back(target->first, target->second);
+    }
+    return targets;
+}
+
+void ConversionPlan::addTarget(std::string_view unit,
+                               Coefficients coefficients) {
+    toUnits.push_back(unit);
+    targetKind.push_back(coefficients.kind);
+    targetScale.push_back(coefficients.scale);
+    targetOffset.push_back(coefficients.offset);
+    linear = linear && coefficients.kind == ConversionKind::LINEAR;
+}
+
+bool ConversionPlan::isAffine() const {
+    return std::all_of(targetKind.begin(), targetKind.end(),
+                       [](ConversionKind kind) {
+                           return kind == ConversionKind::LINEAR ||
+                                  kind == ConversionKind::AFFINE;
+                       });
+}
+
+// "<nombre> <unité>", éventuellement précédé de '-'
+static bool isSingleQuantity(const std::pmr::vector<ExprNode> &expr) {
+    return expr.size() >= 2 && expr[0].kind == ExprNode::Kind::NUMBER &&
+           expr[1].kind == ExprNode::Kind::UNIT &&
+           std::all_of(expr.begin() + 2, expr.end(), [](const ExprNode &n) {
+               return n.kind == ExprNode::Kind::NEG;
+           });
+}
+
+// Compile l'expression postfixe: les unités deviennent des facteurs vers
+// l'unité de base de leur dimension; chaque cible applique ensuite les
+// coefficients de l'unité de base vers elle-même
+ConversionPlan ConversionPlan::compile(const ConversionRequest &request) {
+    if (isSingleQuantity(request.expression)) {
+        return compileSingle(request);
+    }
+    auto targets = targetsOf(request);
+
+    ConversionPlan plan;
+    std::vector<Value> stack;
+
+    for (const ExprNode &node : request.expression) {
+        switch (node.kind) {
+        case ExprNode::Kind::NUMBER:
+            if (plan.slots == MAX_SLOTS || stack.size() == MAX_DEPTH) {
+                throw std::runtime_error("Expression trop complexe");
+            }
+            plan.emit(Op::Code::PUSH, 0.0,
+                      static_cast<uint32_t>(plan.slots++));
+            stack.push_back(Value{false, UnitType::WEIGHT, {}});
+            break;
+
+        case ExprNode::Kind::UNIT: {
+            auto unit = UnitSet.find(node.unit);
+            if (unit == UnitSet.end()) {
+                throw std::runtime_error(
+                    std::string("Unité source invalide: ").append(node.unit));
+            }
+            if (stack.back().quantity) {
+                throw std::runtime_error(
+                    std::string("Unité en trop: ").append(node.unit));
+            }
+            // Températures, niveaux, consommations: pas d'addition possible
+            auto factor = UnitFactors.find(unit->first);
+            if (factor == UnitFactors.end()) {
+                throw std::runtime_error(
+                    std::string("Unité non linéaire dans une expression: ")
+                        .append(node.unit));
+            }
+            plan.emit(Op::Code::SCALE, factor->second);
+            stack.back() = Value{true, unit->second, unit->first};
+            break;
+        }
+
+        case ExprNode::Kind::ADD:
+        case ExprNode::Kind::SUB: {
+            Value b = stack.back();
+            stack.pop_back();
+            const Value &a = stack.back();
+            if (a.quantity != b.quantity ||
+                (a.quantity && a.type != b.type)) {
+                throw std::runtime_error("Impossible d'additionner " +
+                                         describe(a) + " et " + describe(b) +
+                                         " : dimensions incompatibles");
+            }
+            plan.emit(node.kind == ExprNode::Kind::ADD ? Op::Code::ADD
+                                                       : Op::Code::SUB);
+            break;
+        }
+
+        case ExprNode::Kind::MUL: {
+            Value b = stack.back();
+            stack.pop_back();
+            Value &a = stack.back();
+            if (a.quantity && b.quantity) {
+                throw std::runtime_error("Impossible de multiplier " +
+                                         describe(a) + " par " + describe(b) +
+                                         " : dimension non supportée");
+            }
+            if (b.quantity) {
+                a = b;
+            }
+            plan.emit(Op::Code::MUL);
+            break;
+        }
+
+        case ExprNode::Kind::DIV: {
+            Value b = stack.back();
+            stack.pop_back();
+            Value &a = stack.back();
+            if (b.quantity && !(a.quantity && a.type == b.type)) {
+                throw std::runtime_error("Impossible de diviser " +
+                                         describe(a) + " par " + describe(b) +
+                                         " : dimension non supportée");
+            }
+            // Rapport de deux quantités de même dimension: un nombre
+            if (b.quantity) {
+                a = Value{false, UnitType::WEIGHT, {}};
+            }
+            plan.emit(Op::Code::DIV);
+            break;
+        }
+
+        case ExprNode::Kind::NEG:
+            plan.emit(Op::Code::NEG);
+            break;
+        }
+    }
+
+    const Value &result = stack.back();
+    if (!result.quantity) {
+        throw std::runtime_error("L'expression n'a pas d'unité");
+    }
+    for (const auto &[unit, type] : targets) {
+        if (type != result.type) {
+            throw std::runtime_error(std::string("Impossible de convertir ")
+                                         .append(result.unit)
+                                         .append(" en ")
+                                         .append(unit)
+                                         .append(" : dimensions incompatibles"));
+        }
+        plan.addTarget(unit, pairCoefficients(baseUnit(type), unit));
+    }
+    return plan;
+}
+
+// Quantité seule: les coefficients de la paire (source, cible) du registre,
+// sans passer par l'unité de base
+ConversionPlan ConversionPlan::compileSingle(const ConversionRequest &request) {
+    const auto &expr = request.expression;
+    auto from = UnitSet.find(expr[1].unit);
+    if (from == UnitSet.end()) {
+        throw std::runtime_error(
+            std::string("Unité source invalide: ").append(expr[1].unit));
+    }
+
+    // Même borne que le parser pour une chaîne de '-'
+    if (expr.size() - 2 > MAX_DEPTH) {
+        throw std::runtime_error("Expression trop complexe");
+    }
+
+    ConversionPlan plan;
+    plan.slots = 1;
+    plan.emit(Op::Code::PUSH, 0.0, 0);
+    for (size_t i = 2; i < expr.size(); i++) {
+        plan.emit(Op::Code::NEG);
+    }
+
+    for (const auto &[unit, type] : targetsOf(request)) {
+        if (type != from->second) {
+            throw std::runtime_error(std::string("Impossible de convertir ")
+                                         .append(from->first)
+                                         .append(" en ")
+                                         .append(unit)
+                                         .append(" : dimensions incompatibles"));
+        }
+        plan.addTarget(unit, pairCoefficients(from->first, unit));
+    }
+    return plan;
+}
+
+float ConversionPlan::evaluate(const float *in) const {
+    float result[MAX_TARGETS];
+    evaluateAll(in, result);
+    return result[0];
+}
+
+void ConversionPlan::evaluateAll(const float *in, float *out) const {
+    evaluateBatch(in, 1, out);
+}
+
+namespace {
+
+// Résultat exact (en double) d'une valeur pour un type de conversion
+template <ConversionKind kind>
+inline double mapValue(double x, double scale, double offset) {
+    if constexpr (kind == ConversionKind::LINEAR) {
+        return x * scale;
+    } else if constexpr (kind == ConversionKind::AFFINE) {
+        return x * scale + offset;
+    } else if constexpr (kind == ConversionKind::RECIPROCAL) {
+        return scale / x;
+    } else if constexpr (kind == ConversionKind::LOGARITHMIC) {
+        return scale * std::log(x) + offset;
+    } else {
+        return std::exp(x * scale + offset);
+    }
+}
+
+// Idem pour un type connu à l'exécution
+inline double mapAny(ConversionKind kind, double x, double scale,
+                     double offset) {
+    switch (kind) {
+    case ConversionKind::LINEAR:
+        return mapValue<ConversionKind::LINEAR>(x, scale, offset);
+    case ConversionKind::AFFINE:
+        return mapValue<ConversionKind::AFFINE>(x, scale, offset);
+    case ConversionKind::RECIPROCAL:
+        return mapValue<ConversionKind::RECIPROCAL>(x, scale, offset);
+    case ConversionKind::LOGARITHMIC:
+        return mapValue<ConversionKind::LOGARITHMIC>(x, scale, offset);
+    case ConversionKind::EXPONENTIAL:
+        return mapValue<ConversionKind::EXPONENTIAL>(x, scale, offset);
+    }
+    return NAN;
+}
+
+// Une cible sur n valeurs: une boucle sans branche par type de conversion
+template <ConversionKind kind, typename T>
+void applyKind(const T *in, size_t n, double scale, double offset,
+               float *out) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = static_cast<float>(mapValue<kind>(in[i], scale, offset));
+    }
+}
+
+// Même boucle, chaque résultat encodé sur 16 bits puis relu pour mesurer
+// son erreur; les accumulateurs sont locaux pour rester en registres
+template <ConversionKind kind, StorageFormat format>
+void narrowKind(const float *in, size_t n, double scale, double offset,
+                double step, uint16_t *out, PrecisionReport &report) {
+    double inverseStep = 1.0 / step;
+    double maxAbs = report.maxAbsError;
+    double maxRel = report.maxRelError;
+    double sumSquares = 0.0;
+    size_t overflows = 0;
+    for (size_t i = 0; i < n; i++) {
+        double y = mapValue<kind>(in[i], scale, offset);
+        uint16_t code = encodeStorage<format>(y, inverseStep);
+        out[i] = code;
+
+        double decoded = decodeStorage<format>(code, step);
+        // Débordement: valeur finie devenue infinie, ou saturée
+        bool finite = std::isfinite(y);
+        bool overflow;
+        if constexpr (format == StorageFormat::FIXED16) {
+            overflow =
+                finite && std::fabs(y * inverseStep) > FIXED16_MAX + 0.5;
+        } else {
+            overflow = finite && !std::isfinite(decoded);
+        }
+        overflows += overflow;
+        double error = finite && !overflow ? std::fabs(decoded - y) : 0.0;
+        double relative = y != 0.0 ? error / std::fabs(y) : 0.0;
+        maxAbs = error > maxAbs ? error : maxAbs;
+        maxRel = relative > maxRel ? relative : maxRel;
+        sumSquares += error * error;
+    }
+    report.count += n;
+    report.maxAbsError = maxAbs;
+    report.maxRelError = maxRel;
+    report.sumSquares += sumSquares;
+    report.overflows += overflows;
+}
+
+template <StorageFormat format>
+void narrowAny(const Coefficients &c, const float *in, size_t n, double step,
+               uint16_t *out, PrecisionReport &report) {
+    switch (c.kind) {
+    case ConversionKind::LINEAR:
+        narrowKind<ConversionKind::LINEAR, format>(in, n, c.scale, c.offset,
+                                                   step, out, report);
+        break;
+    case ConversionKind::AFFINE:
+        narrowKind<ConversionKind::AFFINE, format>(in, n, c.scale, c.offset,
+                                                   step, out, report);
+        break;
+    case ConversionKind::RECIPROCAL:
+        narrowKind<ConversionKind::RECIPROCAL, format>(
+            in, n, c.scale, c.offset, step, out, report);
+        break;
+    case ConversionKind::LOGARITHMIC:
+        narrowKind<ConversionKind::LOGARITHMIC, format>(
+            in, n, c.scale, c.offset, step, out, report);
+        break;
+    case ConversionKind::EXPONENTIAL:
+        narrowKind<ConversionKind::EXPONENTIAL, format>(
+            in, n, c.scale, c.offset, step, out, report);
+        break;
+    }
+}
+
+// Aiguillage vers la boucle du type de conversion
+template <typename T>
+void applyAny(ConversionKind kind, const T *in, size_t n, double scale,
+              double offset, float *out) {
+    switch (kind) {
+    case ConversionKind::LINEAR:
+        applyKind<ConversionKind::LINEAR>(in, n, scale, offset, out);
+        break;
+    case ConversionKind::AFFINE:
+        applyKind<ConversionKind::AFFINE>(in, n, scale, offset, out);
+        break;
+    case ConversionKind::RECIPROCAL:
+        applyKind<ConversionKind::RECIPROCAL>(in, n, scale, offset, out);
+        break;
+    case ConversionKind::LOGARITHMIC:
+        applyKind<ConversionKind::LOGARITHMIC>(in, n, scale, offset, out);
+        break;
+    case ConversionKind::EXPONENTIAL:
+        applyKind<ConversionKind::EXPONENTIAL>(in, n, scale, offset, out);
+        break;
+    }
+}
+
+} // namespace
+
+void applyCoefficients(const Coefficients &coefficients, const float *in,
+                       size_t n, float *out) {
+    applyAny(coefficients.kind, in, n, coefficients.scale,
+             coefficients.offset, out);
+}
+
+void applyCoefficients(const Coefficients &coefficients, const float *in,
+                       size_t n, StorageFormat format, double step,
+                       uint16_t *out, PrecisionReport &report) {
+    switch (format) {
+    case StorageFormat::FLOAT16:
+        narrowAny<StorageFormat::FLOAT16>(coefficients, in, n, step, out,
+                                          report);
+        break;
+    case StorageFormat::BFLOAT16:
+        narrowAny<StorageFormat::BFLOAT16>(coefficients, in, n, step, out,
+                                           report);
+        break;
+    case StorageFormat::FIXED16:
+        narrowAny<StorageFormat::FIXED16>(coefficients, in, n, step, out,
+                                          report);
+        break;
+    }
+}
+
+double resultBound(const Coefficients &coefficients, float low, float high) {
+    // Conversions monotones: les extrêmes sont aux bornes de l'intervalle
+    double bound = 0.0;
+    for (float x : {low, high}) {
+        double y = mapAny(coefficients.kind, x, coefficients.scale,
+                          coefficients.offset);
+        if (std::isfinite(y)) {
+            bound = std::max(bound, std::fabs(y));
+        }
+    }
+    return bound;
+}
+
+std::string domainError(ConversionKind kind, std::string_view unit) {
+    return std::string("Valeur hors du domaine de la conversion vers ")
+        .append(unit)
+        .append(kind == ConversionKind::LOGARITHMIC
+                    ? " (valeur > 0 attendue)"
+                    : " (valeur non nulle attendue)");
+}
+
+void ConversionPlan::applyTargets(const double *base, size_t n, float *out,
+                                  size_t stride) const {
+    // Calcul en double, un seul arrondi vers float par résultat
+    const double *scale = targetScale.data();
+    const double *offset = targetOffset.data();
+    size_t targets = toUnits.size();
+
+    // Domaine des cibles non linéaires, vérifié avant d'écrire out
+    for (size_t t = 0; !linear && t < targets; t++) {
+        for (size_t i = 0; i < n; i++) {
+            if (!inDomain(targetKind[t], base[i])) {
+                throw std::runtime_error(
+                    domainError(targetKind[t], toUnits[t]));
+            }
+        }
+    }
+
+    if (n == 1 && linear) {
+        // Une requête, plusieurs cibles linéaires: boucle sur les cibles
+        double b = base[0];
+        for (size_t t = 0; t < targets; t++)
+            out[t * stride] = static_cast<float>(b * scale[t]);
+        return;
+    }
+
+    for (size_t t = 0; t < targets; t++) {
+        applyAny(targetKind[t], base, n, scale[t], offset[t],
+                 out + t * stride);
+    }
+}
+
+void ConversionPlan::evaluateBatch(const float *in, size_t count,
+                                   float *out) const {
+    // Pile de colonnes: chaque opération traite un bloc entier
+    constexpr size_t BLOCK = 256;
+    double stack[MAX_DEPTH][BLOCK];
+
+    for (size_t base = 0; base < count; base += BLOCK) {
+        size_t n = std::min(BLOCK, count - base);
+        size_t sp = 0;
+
+        for (const Op &op : ops) {
+            double *top = sp > 0 ? stack[sp - 1] : nullptr;
+            double *below = sp > 1 ? stack[sp - 2] : nullptr;
+            double k = op.factor;
+
+            switch (op.code) {
+            case Op::Code::PUSH:
+                std::copy_n(in + op.slot * count + base, n, stack[sp]);
+                sp++;
+                break;
+            case Op::Code::SCALE:
+                for (size_t i = 0; i < n; i++)
+                    top[i] *= k;
+                break;
+            case Op::Code::ADD:
+                for (size_t i = 0; i < n; i++)
+                    below[i] += top[i];
+                sp--;
+                break;
+            case Op::Code::SUB:
+                for (size_t i = 0; i < n; i++)
+                    below[i] -= top[i];
+                sp--;
+                break;
+            case Op::Code::MUL:
+                for (size_t i = 0; i < n; i++)
+                    below[i] *= top[i];
+                sp--;
+                break;
+            case Op::Code::DIV:
+                // Diviseur nul: erreur de domaine plutôt que inf ou NaN
+                if (std::find(top, top + n, 0.0) != top + n) {
+                    throw std::runtime_error(
+                        "Valeur hors du domaine de la division "
+                        "(diviseur non nul attendu)");
+                }
+                for (size_t i = 0; i < n; i++)
+                    below[i] /= top[i];
+                sp--;
+                break;
+            case Op::Code::NEG:
+                for (size_t i = 0; i < n; i++)
+                    top[i] = -top[i];
+                break;
+            }
+        }
+
+        applyTargets(stack[0], n, out + base, count);
+    }
+}
+
+void PlanCache::shapeKey(const TokenList &tokens, std::string &key) {
+    key.clear();
+    for (const Token &token : tokens) {
+        if (token.type == TokenType::DECIMAL) {
+            key += '#';
+        } else {
+            key += token.value;
+        }
+        key += ' ';
+    }
+}
+
+const ConversionPlan *PlanCache::find(const TokenList &tokens) {
+    shapeKey(tokens, key);
+    auto it = plans.find(key);
+    return it == plans.end() ? nullptr : &it->second;
+}
+
+const ConversionPlan &PlanCache::insert(const TokenList &tokens,
+                                        ConversionPlan plan) {
+    if (plans.size() >= MAX_PLANS) {
+        plans.clear();
+    }
+    shapeKey(tokens, key);
+    return plans.emplace(key, std::move(plan)).first->second;
+}
+
+size_t readSlots(const TokenList &tokens, float *slots) {
+    size_t count = 0;
+    for (const Token &token : tokens) {
+        if (token.type != TokenType::DECIMAL) {
+            continue;
+        }
+        if (count == ConversionPlan::MAX_SLOTS) {
+            throw std::runtime_error("Expression trop complexe");
+        }
+        auto value = decimalValue(token.value);
+        if (!value.has_value()) {
+            throw std::runtime_error(
+                "Erreur: Impossible de parser la requête de conversion");
+        }
+        slots[count++] = *value;
+    }
+    return count;
+}
@@ -0,0 +1,195 @@
+#include "../include/RequestBatch.hpp"
+#include "../include/Plan.hpp"
+#include <algorithm>
+
+bool RequestBatch::push(float value, UnitId from, UnitId to) {
+    if (from >= UnitSet.size() || to >= UnitSet.size()) {
+        return false;
+    }
+    size_t cell = from * UnitSet.size() + to;
+    uint32_t group = groupOf[cell];
+    PairId pair = 0;
+    if (group != NO_GROUP) {
+        pair = pairs[group];
+    } else if (auto id = pairId(from, to)) {
+        pair = *id;
+    } else {
+        return false;
+    }
+    // Hors du domaine de la paire: le noyau rendrait -inf, NaN ou inf
+    if (!inDomain(pairCoefficients(pair).kind, value)) {
+        return false;
+    }
+    if (group == NO_GROUP) {
+        group = static_cast<uint32_t>(pairs.size());
+        groupOf[cell] = group;
+        pairs.push_back(pair);
+        rows.push_back(0);
+        cells.push_back(static_cast<uint32_t>(cell));
+    }
+    rows[group]++;
+
+    values.push_back(value);
+    fromIds.push_back(from);
+    toIds.push_back(to);
+    groups.push_back(group);
+    return true;
+}
+
+bool RequestBatch::push(const TokenList &tokens) {
+    if (tokens.size() != 5 || tokens[0].type != TokenType::KEYWORD ||
+        tokens[0].value != "convert" ||
+        tokens[1].type != TokenType::DECIMAL ||
+        tokens[2].type != TokenType::UNIT ||
+        tokens[3].type != TokenType::KEYWORD || tokens[3].value != "to" ||
+        tokens[4].type != TokenType::UNIT) {
+        return false;
+    }
+    auto value = decimalValue(tokens[1].value);
+    auto from = unitId(tokens[2].value);
+    auto to = unitId(tokens[4].value);
+    if (!value.has_value() || !from.has_value() || !to.has_value()) {
+        return false;
+    }
+    // Hors du domaine de la paire: push() refuse, la requête seule
+    // signale l'erreur
+    return push(*value, *from, *to);
+}
+
+void RequestBatch::groupRows() {
+    size_t n = values.size();
+
+    // Tri par dénombrement: début de la plage de chaque groupe
+    next.resize(pairs.size());
+    uint32_t offset = 0;
+    for (size_t g = 0; g < pairs.size(); g++) {
+        next[g] = offset;
+        offset += rows[g];
+    }
+
+    // Chaque valeur rejoint la plage de son groupe, dans l'ordre des lignes
+    order.resize(n);
+    grouped.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t slot = next[groups[i]]++;
+        order[slot] = static_cast<uint32_t>(i);
+        grouped[slot] = values[i];
+    }
+}
+
+void RequestBatch::convert(float *out) {
+    size_t n = values.size();
+    groupRows();
+    converted.resize(n);
+
+    // Un appel du noyau par paire, sur sa plage
+    uint32_t begin = 0;
+    for (size_t g = 0; g < pairs.size(); g++) {
+        applyCoefficients(pairCoefficients(pairs[g]), grouped.data() + begin,
+                          rows[g], converted.data() + begin);
+        begin += rows[g];
+    }
+
+    for (size_t k = 0; k < n; k++) {
+        out[order[k]] = converted[k];
+    }
+}
+
+void RequestBatch::convert(StorageFormat format, uint16_t *out,
+                           std::vector<ColumnReport> &report) {
+    size_t n = values.size();
+    groupRows();
+    codes.resize(n);
+
+    // Une colonne par unité cible présente, dans l'ordre des UnitId
+    report.clear();
+    for (uint32_t cell : cells) {
+        auto to = static_cast<UnitId>(cell % UnitSet.size());
+        if (columnOf[to] < 0) {
+            columnOf[to] = 0;
+            report.push_back(ColumnReport{to, {}});
+        }
+    }
+    std::sort(report.begin(), report.end(),
+              [](const ColumnReport &a, const ColumnReport &b) {
+                  return a.unit < b.unit;
+              });
+    for (size_t c = 0; c < report.size(); c++) {
+        columnOf[report[c].unit] = static_cast<int32_t>(c);
+    }
+    auto columnOfGroup = [&](size_t g) -> PrecisionReport & {
+        return report[columnOf[cells[g] % UnitSet.size()]].precision;
+    };
+
+    // FIXED16: borne des résultats de chaque colonne, depuis les extrêmes
+    // des entrées de chaque paire
+    if (format == StorageFormat::FIXED16) {
+        uint32_t begin = 0;
+        for (size_t g = 0; g < pairs.size(); g++) {
+            auto [low, high] = std::minmax_element(
+                grouped.begin() + begin, grouped.begin() + begin + rows[g]);
+            double bound = resultBound(pairCoefficients(pairs[g]), *low,
+                                       *high);
+            // step garde la plus grande borne en attendant fixedStep()
+            PrecisionReport &column = columnOfGroup(g);
+            column.step = std::max(column.step, bound);
+            begin += rows[g];
+        }
+        for (ColumnReport &column : report) {
+            column.precision.step = fixedStep(column.precision.step);
+        }
+    }
+
+    uint32_t begin = 0;
+    for (size_t g = 0; g < pairs.size(); g++) {
+        PrecisionReport &column = columnOfGroup(g);
+        applyCoefficients(pairCoefficients(pairs[g]), grouped.data() + begin,
+                          rows[g], format, column.step, codes.data() + begin,
+                          column);
+        begin += rows[g];
+    }
+
+    for (size_t k = 0; k < n; k++) {
+        out[order[k]] = codes[k];
+    }
+    for (const ColumnReport &column : report) {
+        columnOf[column.unit] = -1;
+    }
+}
+
+void RequestBatch::convertStored(StorageFormat format, float *out,
+                                 std::vector<PrecisionReport> &reports) {
+    size_t n = values.size();
+    stored.resize(n);
+    convert(format, stored.data(), columns);
+
+    reports.resize(UnitSet.size());
+    for (size_t c = 0; c < columns.size(); c++) {
+        const ColumnReport &column = columns[c];
+        PrecisionReport &total = reports[column.unit];
+        total.step = std::max(total.step, column.precision.step);
+        total.merge(column.precision);
+        columnOf[column.unit] = static_cast<int32_t>(c);
+    }
+    // Un code décodé tient dans un float: 16 bits significatifs au plus
+    for (size_t i = 0; i < n; i++) {
+        double step = columns[columnOf[toIds[i]]].precision.step;
+        out[i] = static_cast<float>(decodeStorage(format, stored[i], step));
+    }
+    for (const ColumnReport &column : columns) {
+        columnOf[column.unit] = -1;
+    }
+}
+
+void RequestBatch::clear() {
+    for (uint32_t cell : cells) {
+        groupOf[cell] = NO_GROUP;
+    }
+    pairs.clear();
+    rows.clear();
+    cells.clear();
+    values.clear();
+    fromIds.clear();
+    toIds.clear();
+    groups.clear();
+}
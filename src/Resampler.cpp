@@ -0,0 +1,167 @@
+#include "../include/Resampler.hpp"
+#include <stdexcept>
+
+namespace {
+
+// Requête équivalente à "convert # <from> to <to>"
+ConversionRequest singleRequest(std::string_view fromUnit,
+                                std::string_view toUnit) {
+    ConversionRequest request{0.0f, std::pmr::string(fromUnit),
+                              std::pmr::string(toUnit), {}, {}};
+    request.expression.push_back(
+        ExprNode{ExprNode::Kind::NUMBER, 0.0f, std::pmr::string()});
+    request.expression.push_back(
+        ExprNode{ExprNode::Kind::UNIT, 0.0f, std::pmr::string(fromUnit)});
+    return request;
+}
+
+} // namespace
+
+Resampler::Resampler(std::string_view fromUnit, std::string_view toUnit,
+                     int64_t length)
+    : plan(ConversionPlan::compile(singleRequest(fromUnit, toUnit))),
+      length(length), kind(pairCoefficients(fromUnit, toUnit).kind),
+      convertFirst(!plan.isAffine()) {
+    if (length <= 0) {
+        throw std::runtime_error("Durée de fenêtre invalide");
+    }
+}
+
+int64_t Resampler::windowStart(int64_t timestamp) const {
+    // Division arrondie vers -inf: les horodatages négatifs restent valides
+    int64_t k = timestamp / length;
+    if (timestamp % length < 0) {
+        k--;
+    }
+    return k * length;
+}
+
+void Resampler::check(int64_t timestamp, float value) {
+    int64_t start = windowStart(timestamp);
+    if (checked && start < checkedStart) {
+        throw std::runtime_error("Horodatage antérieur à la fenêtre "
+                                 "courante");
+    }
+    if (!inDomain(kind, value)) {
+        throw std::runtime_error(domainError(kind, plan.targetUnit()));
+    }
+    checked = true;
+    checkedStart = start;
+}
+
+void Resampler::reduce(const float *values, size_t count) {
+    // Voies indépendantes: pas de dépendance entre itérations, la boucle
+    // interne est vectorisée
+    constexpr size_t LANES = 8;
+    float lo[LANES];
+    float hi[LANES];
+    double sum[LANES] = {};
+    for (size_t k = 0; k < LANES; k++) {
+        lo[k] = values[0];
+        hi[k] = values[0];
+    }
+
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t k = 0; k < LANES; k++) {
+            float x = values[i + k];
+            lo[k] = x < lo[k] ? x : lo[k];
+            hi[k] = x > hi[k] ? x : hi[k];
+            sum[k] += x;
+        }
+    }
+    for (; i < count; i++) {
+        lo[0] = values[i] < lo[0] ? values[i] : lo[0];
+        hi[0] = values[i] > hi[0] ? values[i] : hi[0];
+        sum[0] += values[i];
+    }
+
+    for (size_t k = 0; k < LANES; k++) {
+        current.min = lo[k] < current.min ? lo[k] : current.min;
+        current.max = hi[k] > current.max ? hi[k] : current.max;
+        current.sum += sum[k];
+    }
+    current.count += count;
+}
+
+void Resampler::push(const int64_t *timestamps, const float *values,
+                     size_t count, std::vector<Window> &out) {
+    // Conversion non affine (mpg, dBm...): la moyenne ne commute pas, les
+    // échantillons sont convertis avant la réduction
+    if (convertFirst && count > 0) {
+        samples.resize(count);
+        plan.evaluateBatch(values, count, samples.data());
+        values = samples.data();
+    }
+
+    size_t i = 0;
+    while (i < count) {
+        int64_t start = windowStart(timestamps[i]);
+        if (open && start < current.start) {
+            throw std::runtime_error("Horodatage antérieur à la fenêtre "
+                                     "courante");
+        }
+        if (!open || start != current.start) {
+            if (open) {
+                closed.push_back(current);
+            }
+            current = Partial{start, 0, 0.0, values[i], values[i]};
+            open = true;
+        }
+
+        // Échantillons contigus de la même fenêtre
+        size_t end = i + 1;
+        int64_t limit = start + length;
+        while (end < count && timestamps[end] >= start &&
+               timestamps[end] < limit) {
+            end++;
+        }
+        reduce(values + i, end - i);
+        i = end;
+    }
+    emit(out);
+}
+
+void Resampler::finish(std::vector<Window> &out) {
+    if (open) {
+        closed.push_back(current);
+        open = false;
+    }
+    emit(out);
+}
+
+void Resampler::emit(std::vector<Window> &out) {
+    size_t n = closed.size();
+    if (n == 0) {
+        return;
+    }
+    if (convertFirst) {
+        for (const Partial &w : closed) {
+            out.push_back(Window{
+                w.start, w.count,
+                static_cast<float>(w.sum / static_cast<double>(w.count)),
+                w.min, w.max});
+        }
+        closed.clear();
+        return;
+    }
+
+    // Moyennes, minimums et maximums bout à bout: une seule évaluation du
+    // plan pour toutes les fenêtres terminées
+    scratch.resize(6 * n);
+    float *in = scratch.data();
+    for (size_t w = 0; w < n; w++) {
+        in[w] = static_cast<float>(closed[w].sum /
+                                   static_cast<double>(closed[w].count));
+        in[n + w] = closed[w].min;
+        in[2 * n + w] = closed[w].max;
+    }
+    float *converted = in + 3 * n;
+    plan.evaluateBatch(in, 3 * n, converted);
+
+    for (size_t w = 0; w < n; w++) {
+        out.push_back(Window{closed[w].start, closed[w].count, converted[w],
+                             converted[n + w], converted[2 * n + w]});
+    }
+    closed.clear();
+}
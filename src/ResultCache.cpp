@@ -0,0 +1,184 @@
+#include "../include/ResultCache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[8] = {'C', 'N', 'V', 'C', 'A', 'C', 'H', 'E'};
+
+} // namespace
+
+ResultCache::ResultCache(std::string path, uint64_t version)
+    : path(std::move(path)), version(version) {
+    load();
+}
+
+ResultCache::~ResultCache() { unmap(); }
+
+uint64_t ResultCache::chunkKey(std::string_view chunk, uint64_t seed) {
+    // FNV-1a 64 bits, la graine d'abord
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof seed; i++) {
+        h = (h ^ ((seed >> (8 * i)) & 0xFF)) * 1099511628211ULL;
+    }
+    for (char c : chunk) {
+        h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return h;
+}
+
+void ResultCache::load() {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return;
+    }
+
+    mappingSize = static_cast<size_t>(st.st_size);
+    mapping = ::mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        return;
+    }
+
+    // Fichier d'une autre version ou tronqué: on repart de zéro
+    Header header;
+    std::memcpy(&header, mapping, sizeof header);
+    size_t available = mappingSize - sizeof(Header);
+    if (std::memcmp(header.magic, MAGIC, sizeof MAGIC) != 0 ||
+        header.version != version ||
+        header.count > available / sizeof(Entry)) {
+        unmap();
+        return;
+    }
+
+    const char *base = static_cast<const char *>(mapping);
+    entries = reinterpret_cast<const Entry *>(base + sizeof(Header));
+    entryCount = header.count;
+    data = base + sizeof(Header) + entryCount * sizeof(Entry);
+
+    size_t dataSize = available - entryCount * sizeof(Entry);
+    for (size_t i = 0; i < entryCount; i++) {
+        const Entry &e = entries[i];
+        if (e.offset > dataSize || e.length > dataSize - e.offset ||
+            (i > 0 && entries[i - 1].key >= e.key)) {
+            unmap();
+            return;
+        }
+    }
+    used.assign(entryCount, false);
+}
+
+void ResultCache::unmap() {
+    if (mapping != nullptr) {
+        ::munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    entries = nullptr;
+    entryCount = 0;
+    data = nullptr;
+    used.clear();
+}
+
+std::optional<std::string_view> ResultCache::find(uint64_t key) {
+    const Entry *end = entries + entryCount;
+    const Entry *it = std::lower_bound(
+        entries, end, key,
+        [](const Entry &e, uint64_t k) { return e.key < k; });
+    if (it != end && it->key == key) {
+        used[static_cast<size_t>(it - entries)] = true;
+        hitCount++;
+        return std::string_view(data + it->offset, it->length);
+    }
+
+    auto fresh = added.find(key);
+    if (fresh != added.end()) {
+        hitCount++;
+        return std::string_view(fresh->second);
+    }
+    missCount++;
+    return std::nullopt;
+}
+
+void ResultCache::insert(uint64_t key, std::string output) {
+    added.insert_or_assign(key, std::move(output));
+}
+
+void ResultCache::save() {
+    if (added.empty()) {
+        return;
+    }
+
+    // Entrées conservées: toutes, sauf si le fichier devient trop gros
+    bool keepAll = entryCount + added.size() <= MAX_ENTRIES;
+    std::vector<std::pair<uint64_t, std::string_view>> kept;
+    kept.reserve(entryCount + added.size());
+    for (size_t i = 0; i < entryCount; i++) {
+        if ((keepAll || used[i]) && added.count(entries[i].key) == 0) {
+            kept.emplace_back(entries[i].key,
+                              std::string_view(data + entries[i].offset,
+                                               entries[i].length));
+        }
+    }
+    for (const auto &[key, output] : added) {
+        kept.emplace_back(key, output);
+    }
+    std::sort(kept.begin(), kept.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof MAGIC);
+    header.version = version;
+    header.count = kept.size();
+
+    std::vector<Entry> table;
+    table.reserve(kept.size());
+    uint64_t offset = 0;
+    for (const auto &[key, output] : kept) {
+        table.push_back(Entry{key, offset, output.size()});
+        offset += output.size();
+    }
+
+    // Écriture dans un fichier temporaire puis renommage atomique: un
+    // lecteur concurrent voit l'ancien ou le nouveau fichier, jamais un mélange
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof header);
+        out.write(reinterpret_cast<const char *>(table.data()),
+                  static_cast<std::streamsize>(table.size() * sizeof(Entry)));
+        for (const auto &[key, output] : kept) {
+            out.write(output.data(),
+                      static_cast<std::streamsize>(output.size()));
+        }
+        if (!out.flush()) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Impossible d'écrire le cache " +
+                                     temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Impossible de remplacer le cache " + path);
+    }
+
+    // Les vues de kept pointent dans l'ancien mapping: on recharge après
+    added.clear();
+    unmap();
+    load();
+}
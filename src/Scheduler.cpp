@@ -0,0 +1,157 @@
+#include "../include/Scheduler.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Pool et numéro du worker du thread courant
+thread_local const Scheduler *currentPool = nullptr;
+thread_local int currentIndex = -1;
+
+} // namespace
+
+Scheduler::Scheduler(unsigned count)
+    : started(std::chrono::steady_clock::now()) {
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(count);
+    for (unsigned i = 0; i < count; i++) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->victim = (i + 1) % count;
+    }
+    // Tous les workers existent avant qu'un premier vol soit tenté
+    for (unsigned i = 0; i < count; i++) {
+        workers[i]->thread = std::thread([this, i] { run(i); });
+    }
+}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers) {
+        worker->thread.join();
+    }
+}
+
+int Scheduler::currentWorker() { return currentIndex; }
+
+void Scheduler::spawn(Task task) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    unsigned index = currentPool == this
+                         ? static_cast<unsigned>(currentIndex)
+                         : next.fetch_add(1, std::memory_order_relaxed) %
+                               size();
+    Worker &worker = *workers[index];
+    {
+        std::lock_guard<std::mutex> guard(worker.lock);
+        worker.tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    // Le verrou ordonne l'ajout avant le test d'un worker qui s'endort
+    { std::lock_guard<std::mutex> guard(sleepLock); }
+    wake.notify_one();
+}
+
+bool Scheduler::take(unsigned index, Task &task) {
+    Worker &self = *workers[index];
+    {
+        std::lock_guard<std::mutex> guard(self.lock);
+        if (!self.tasks.empty()) {
+            task = std::move(self.tasks.back());
+            self.tasks.pop_back();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Vol de la tâche la plus ancienne, en partant d'une victime qui
+    // tourne pour ne pas vider toujours la même file
+    for (unsigned tries = 1; tries < size(); tries++) {
+        unsigned victim = self.victim;
+        self.victim = (victim + 1) % size();
+        if (victim == index) {
+            continue;
+        }
+        Worker &other = *workers[victim];
+        std::lock_guard<std::mutex> guard(other.lock);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            self.stats.steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Scheduler::run(unsigned index) {
+    currentPool = this;
+    currentIndex = static_cast<int>(index);
+    Worker &self = *workers[index];
+    Task task;
+
+    while (true) {
+        if (!take(index, task)) {
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [&] {
+                return stopping ||
+                       queued.load(std::memory_order_acquire) > 0;
+            });
+            if (stopping && queued.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+        task = nullptr;
+        std::chrono::duration<double> busy =
+            std::chrono::steady_clock::now() - start;
+        self.stats.busy += busy.count();
+        self.stats.tasks++;
+
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            done.notify_all();
+        }
+    }
+}
+
+void Scheduler::wait() {
+    std::unique_lock<std::mutex> guard(sleepLock);
+    done.wait(guard,
+              [&] { return pending.load(std::memory_order_acquire) == 0; });
+    if (failure) {
+        std::exception_ptr error = std::exchange(failure, nullptr);
+        std::rethrow_exception(error);
+    }
+}
+
+std::vector<Scheduler::WorkerStats> Scheduler::stats() const {
+    std::vector<WorkerStats> result;
+    result.reserve(workers.size());
+    for (const auto &worker : workers) {
+        result.push_back(worker->stats);
+    }
+    return result;
+}
+
+double Scheduler::elapsed() const {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - started;
+    return elapsed.count();
+}
@@ -0,0 +1,293 @@
+#include "../include/ShmRing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[8] = {'C', 'N', 'V', 'R', 'I', 'N', 'G', '\0'};
+
+/// Version de la disposition en mémoire: à changer avec Header ou Slot
+constexpr uint32_t LAYOUT_VERSION = 1;
+
+[[noreturn]] void fail(const std::string &what, int error) {
+    throw std::runtime_error(what + ": " + std::strerror(error));
+}
+
+// Attente active courte: pause du processeur (x86), sans appel système
+inline void relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/// Capacité acceptée par create() et attach(): puissance de deux, au moins 2
+bool validCapacity(size_t capacity) {
+    return capacity >= 2 && (capacity & (capacity - 1)) == 0 &&
+           capacity <= UINT32_MAX;
+}
+
+} // namespace
+
+// Les processus partagent ces compteurs: ils doivent être sans verrou
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+struct ShmRing::Header {
+    char magic[8];
+    /// Écrite en dernier par create(): 0 tant que l'anneau s'initialise
+    std::atomic<uint32_t> version;
+    uint32_t capacity;
+    std::atomic<uint32_t> closed; ///< Plus aucune écriture à venir
+    alignas(64) std::atomic<uint64_t> tail; ///< Prochaine position à prendre
+    alignas(64) std::atomic<uint64_t> head; ///< Prochaine position à lire
+};
+
+struct ShmRing::Slot {
+    /// position: libre pour le producteur de ce tour; position + 1:
+    /// publié pour le consommateur
+    std::atomic<uint64_t> sequence;
+    SampleRecord record;
+};
+
+ShmRing::ShmRing(void *mapping, size_t bytes)
+    : mapping(mapping), bytes(bytes),
+      header(static_cast<Header *>(mapping)),
+      slots(reinterpret_cast<Slot *>(static_cast<char *>(mapping) +
+                                     sizeof(Header))),
+      mask(header->capacity - 1) {}
+
+ShmRing ShmRing::create(const std::string &name, size_t capacity) {
+    if (!validCapacity(capacity)) {
+        throw std::runtime_error(
+            "Capacité d'anneau invalide (puissance de deux attendue)");
+    }
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        fail("Impossible de créer l'anneau " + name, errno);
+    }
+    size_t bytes = sizeof(Header) + capacity * sizeof(Slot);
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        int error = errno;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        fail("Impossible de dimensionner l'anneau " + name, error);
+    }
+    void *mapping =
+        mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        fail("Impossible de projeter l'anneau " + name, error);
+    }
+
+    // Objet neuf, rempli de zéros: les atomiques sont construits en place
+    auto *header = new (mapping) Header{};
+    std::memcpy(header->magic, MAGIC, sizeof MAGIC);
+    header->capacity = static_cast<uint32_t>(capacity);
+    auto *slots = reinterpret_cast<Slot *>(static_cast<char *>(mapping) +
+                                           sizeof(Header));
+    for (size_t i = 0; i < capacity; i++) {
+        new (&slots[i]) Slot{};
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    // La version en dernier: un attach() concurrent ne voit pas d'anneau
+    // à moitié initialisé
+    header->version.store(LAYOUT_VERSION, std::memory_order_release);
+    return ShmRing(mapping, bytes);
+}
+
+ShmRing ShmRing::attach(const std::string &name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        fail("Impossible d'ouvrir l'anneau " + name, errno);
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        int error = errno;
+        ::close(fd);
+        fail("Impossible de lire la taille de l'anneau " + name, error);
+    }
+    auto bytes = static_cast<size_t>(st.st_size);
+    void *mapping = bytes < sizeof(Header)
+                        ? MAP_FAILED
+                        : mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Anneau invalide: " + name);
+    }
+
+    const auto *header = static_cast<const Header *>(mapping);
+    if (header->version.load(std::memory_order_acquire) != LAYOUT_VERSION ||
+        std::memcmp(header->magic, MAGIC, sizeof MAGIC) != 0 ||
+        !validCapacity(header->capacity) ||
+        bytes != sizeof(Header) + size_t{header->capacity} * sizeof(Slot)) {
+        munmap(mapping, bytes);
+        throw std::runtime_error("Anneau invalide: " + name);
+    }
+    return ShmRing(mapping, bytes);
+}
+
+void ShmRing::remove(const std::string &name) { shm_unlink(name.c_str()); }
+
+ShmRing::~ShmRing() {
+    if (mapping != nullptr) {
+        munmap(mapping, bytes);
+    }
+}
+
+ShmRing::ShmRing(ShmRing &&other) noexcept
+    : mapping(other.mapping), bytes(other.bytes), header(other.header),
+      slots(other.slots), mask(other.mask) {
+    other.mapping = nullptr;
+}
+
+ShmRing &ShmRing::operator=(ShmRing &&other) noexcept {
+    if (this != &other) {
+        if (mapping != nullptr) {
+            munmap(mapping, bytes);
+        }
+        mapping = other.mapping;
+        bytes = other.bytes;
+        header = other.header;
+        slots = other.slots;
+        mask = other.mask;
+        other.mapping = nullptr;
+    }
+    return *this;
+}
+
+bool ShmRing::push(const SampleRecord &record) {
+    uint64_t position = header->tail.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot &slot = slots[position & mask];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto lap = static_cast<int64_t>(sequence - position);
+        if (lap == 0) {
+            // Slot libre pour ce tour: le prendre avant un autre producteur
+            if (header->tail.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed)) {
+                slot.record = record;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (lap < 0) {
+            return false; // encore occupé par le tour précédent: plein
+        } else {
+            // Un autre producteur a pris cette position
+            position = header->tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t ShmRing::pop(SampleRecord *out, size_t max) {
+    uint64_t position = header->head.load(std::memory_order_relaxed);
+    size_t n = 0;
+    for (; n < max; n++) {
+        Slot &slot = slots[(position + n) & mask];
+        if (slot.sequence.load(std::memory_order_acquire) !=
+            position + n + 1) {
+            break;
+        }
+        out[n] = slot.record;
+        // Rendu aux producteurs pour le tour suivant
+        slot.sequence.store(position + n + capacity(),
+                            std::memory_order_release);
+    }
+    if (n > 0) {
+        header->head.store(position + n, std::memory_order_release);
+    }
+    return n;
+}
+
+size_t ShmRing::readable() const {
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    return static_cast<size_t>(
+        header->tail.load(std::memory_order_acquire) - head);
+}
+
+size_t ShmRing::writable() const {
+    uint64_t tail = header->tail.load(std::memory_order_relaxed);
+    uint64_t head = header->head.load(std::memory_order_acquire);
+    return capacity() - static_cast<size_t>(tail - head);
+}
+
+void ShmRing::close() { header->closed.store(1, std::memory_order_release); }
+
+bool ShmRing::closed() const {
+    return header->closed.load(std::memory_order_acquire) != 0;
+}
+
+size_t RingConverter::step() {
+    size_t room = std::min(BLOCK, out.writable());
+    if (room == 0) {
+        return 0;
+    }
+    records.resize(BLOCK);
+    size_t n = in.pop(records.data(), room);
+    if (n == 0) {
+        return 0;
+    }
+
+    // Les paires invalides et les valeurs hors du domaine de leur paire ne
+    // vont pas dans le lot: elles sont marquées à la publication
+    batch.clear();
+    for (size_t i = 0; i < n; i++) {
+        const SampleRecord &r = records[i];
+        if (!batch.push(r.value, r.from, r.to)) {
+            records[i].from = INVALID_UNIT;
+        }
+    }
+    results.resize(batch.size());
+    if (store.has_value()) {
+        batch.convertStored(*store, results.data(), storeReports);
+    } else {
+        batch.convert(results.data());
+    }
+
+    size_t row = 0;
+    for (size_t i = 0; i < n; i++) {
+        SampleRecord &r = records[i];
+        if (r.from != INVALID_UNIT) {
+            r.value = results[row++];
+        }
+        // Seul producteur de out, et n ≤ writable(): jamais plein
+        (void)out.push(r);
+    }
+    return n;
+}
+
+uint64_t RingConverter::run() {
+    uint64_t converted = 0;
+    unsigned idle = 0;
+    for (;;) {
+        size_t n = step();
+        converted += n;
+        if (n > 0) {
+            idle = 0;
+            continue;
+        }
+        // Fermé et vide: close() suit le dernier push de chaque producteur,
+        // tous ses records sont donc comptés par readable()
+        if (in.closed() && in.readable() == 0) {
+            break;
+        }
+        if (++idle < 64) {
+            relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    out.close();
+    return converted;
+}
@@ -0,0 +1,57 @@
+#include "../include/Storage.hpp"
+#include <algorithm>
+
+double decodeStorage(StorageFormat format, uint16_t code, double step) {
+    switch (format) {
+    case StorageFormat::FLOAT16:
+        return decodeStorage<StorageFormat::FLOAT16>(code, step);
+    case StorageFormat::BFLOAT16:
+        return decodeStorage<StorageFormat::BFLOAT16>(code, step);
+    case StorageFormat::FIXED16:
+        return decodeStorage<StorageFormat::FIXED16>(code, step);
+    }
+    return NAN;
+}
+
+const char *storageName(StorageFormat format) {
+    switch (format) {
+    case StorageFormat::FLOAT16:
+        return "float16";
+    case StorageFormat::BFLOAT16:
+        return "bfloat16";
+    case StorageFormat::FIXED16:
+        return "fixed16";
+    }
+    return "";
+}
+
+std::optional<StorageFormat> storageFormat(std::string_view name) {
+    for (auto format : {StorageFormat::FLOAT16, StorageFormat::BFLOAT16,
+                        StorageFormat::FIXED16}) {
+        if (name == storageName(format)) {
+            return format;
+        }
+    }
+    return std::nullopt;
+}
+
+double fixedStep(double bound) {
+    if (!(bound > 0.0) || !std::isfinite(bound)) {
+        return 1.0;
+    }
+    // bound / FIXED16_MAX = f × 2^e, f dans [0.5, 1): 2^e suffit, 2^(e-1)
+    // aussi si f vaut exactement 0.5
+    int exponent = 0;
+    double fraction = std::frexp(bound / FIXED16_MAX, &exponent);
+    double step = std::ldexp(1.0, fraction == 0.5 ? exponent - 1 : exponent);
+    // Le quotient est arrondi: vérification sur la borne elle-même
+    return bound / step > FIXED16_MAX ? step * 2.0 : step;
+}
+
+void PrecisionReport::merge(const PrecisionReport &other) {
+    count += other.count;
+    maxAbsError = std::max(maxAbsError, other.maxAbsError);
+    maxRelError = std::max(maxRelError, other.maxRelError);
+    sumSquares += other.sumSquares;
+    overflows += other.overflows;
+}
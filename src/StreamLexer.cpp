@@ -0,0 +1,338 @@
+#include "../include/StreamLexer.hpp"
+#include "../include/ByteClass.hpp"
+#include "../include/Unit.hpp"
+#include "../include/UnitIndex.hpp"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+// Caractères équivalents dans les symboles d'unités, ramenés à celui du
+// registre
+constexpr std::pair<std::string_view, std::string_view> VARIANTS[] = {
+    {"µ", "μ"},      // U+00B5 signe micro → U+03BC mu (μm, μs)
+    {"º", "°"},      // U+00BA indicateur ordinal
+    {"˚", "°"},      // U+02DA rond en chef
+    {"℃", "°C"},     // U+2103 degré Celsius
+    {"℉", "°F"},     // U+2109 degré Fahrenheit
+    {"\u212A", "K"}, // U+212A signe kelvin
+    {"ℓ", "L"},      // U+2113 l cursif (mℓ)
+};
+
+// Le mot contient-il un octet non ASCII ?
+bool hasUtf8(std::string_view word) {
+    return std::any_of(word.begin(), word.end(), [](char c) {
+        return (byteClass(c) & ByteClass::UTF8_LEAD) != 0;
+    });
+}
+
+// Mot avec ses variantes remplacées par le caractère du registre
+std::string foldVariants(std::string_view word) {
+    std::string folded;
+    size_t i = 0;
+    while (i < word.size()) {
+        const auto *variant = std::end(VARIANTS);
+        if (byteClass(word[i]) == ByteClass::UTF8_LEAD) {
+            variant = std::find_if(
+                std::begin(VARIANTS), std::end(VARIANTS), [&](auto &v) {
+                    return word.substr(i, v.first.size()) == v.first;
+                });
+        }
+        if (variant != std::end(VARIANTS)) {
+            folded.append(variant->second);
+            i += variant->first.size();
+        } else {
+            folded.push_back(word[i++]);
+        }
+    }
+    return folded;
+}
+
+// Au-delà, un mot n'est pas une unité même replié (une variante de 3
+// octets peut devenir 1 octet) et à une faute de frappe près: ni repli ni
+// recherche, en O(1) pour un mot très long
+size_t longestWord() {
+    static const size_t longest = [] {
+        size_t bytes = 0;
+        for (const auto &unit : UnitSet) {
+            bytes = std::max(bytes, unit.first.size());
+        }
+        for (const auto &alias : UnitAliases) {
+            bytes = std::max(bytes, alias.first.size());
+        }
+        return 3 * (bytes + 4);
+    }();
+    return longest;
+}
+
+} // namespace
+
+bool StreamLexer::pushUnit(TokenList &tokens, std::string_view word,
+                           bool typos) {
+    if (word.size() > longestWord()) {
+        return false;
+    }
+    std::string folded;
+    if (hasUtf8(word)) {
+        folded = foldVariants(word);
+        word = folded;
+    }
+
+    if (UnitSet.find(word) != UnitSet.end()) {
+        tokens.emplace_back(TokenType::UNIT, word, mr);
+        return true;
+    }
+
+    // Mode tolérant: casse, alias, puis faute de frappe sans ambiguïté
+    if (options.lenient) {
+        const UnitIndex &index = UnitIndex::global();
+        auto unit = index.resolve(word);
+        if (!unit.has_value() && typos) {
+            unit = index.closest(word, 1);
+        }
+        if (unit.has_value()) {
+            tokens.emplace_back(TokenType::UNIT, *unit, mr);
+            return true;
+        }
+    }
+    return false;
+}
+
+void StreamLexer::complete(TokenList &tokens, std::string_view tail) {
+    // Mot à cheval sur deux morceaux: recollé dans pending
+    std::string_view word = tail;
+    if (!pending.empty()) {
+        pending.append(tail);
+        word = pending;
+    }
+    state = State::IDLE;
+    if (std::exchange(invalid, false)) {
+        tokens.emplace_back(TokenType::UNKNOWN, word, mr);
+        word = {};
+    }
+
+    // Chiffres collés à une unité ("5ft11in"): le mot s'arrête avant, les
+    // chiffres et la suite sont relus comme par next(), en avançant dans
+    // word sans copie (un mot "a1a1a1..." reste linéaire)
+    auto digits = [](char c) { return byteClass(c) == ByteClass::DIGIT; };
+    while (!word.empty()) {
+        if (digits(word[0])) {
+            size_t end = std::find_if_not(word.begin(), word.end(), digits) -
+                         word.begin();
+            number.assign(word.substr(0, end));
+            word.remove_prefix(end);
+            if (word.empty()) {
+                // Fin du mot: le nombre continue ("ab12.5")
+                state = State::NUMBER;
+            } else {
+                completeNumber(tokens);
+            }
+        } else if (word[0] == '/') {
+            // Hors d'un mot, '/' est un opérateur
+            tokens.emplace_back(TokenType::OPERATOR, word.substr(0, 1), mr);
+            word.remove_prefix(1);
+        } else if (word == "convert" || word == "to") {
+            tokens.emplace_back(TokenType::KEYWORD, word, mr);
+            word = {};
+        } else if (pushUnit(tokens, word, false)) {
+            word = {};
+        } else {
+            size_t digit =
+                std::find_if(word.begin(), word.end(), digits) - word.begin();
+            std::string_view unit = word.substr(0, digit);
+            if (!pushUnit(tokens, unit, true)) {
+                tokens.emplace_back(TokenType::UNKNOWN, unit, mr);
+            }
+            word.remove_prefix(digit);
+        }
+    }
+    pending.clear();
+}
+
+void StreamLexer::startSequence(unsigned char lead) {
+    // Bornes du deuxième octet: E0 et F0 excluent les formes trop longues,
+    // ED les surrogates UTF-16, F4 ce qui dépasse U+10FFFF
+    utf8Remaining = lead < 0xE0 ? 1 : lead < 0xF0 ? 2 : 3;
+    utf8Lo = lead == 0xE0 ? 0xA0 : lead == 0xF0 ? 0x90 : 0x80;
+    utf8Hi = lead == 0xED ? 0x9F : lead == 0xF4 ? 0x8F : 0xBF;
+    state = State::UTF8;
+}
+
+void StreamLexer::completeNumber(TokenList &tokens) {
+    tokens.emplace_back(TokenType::DECIMAL, number, mr);
+    number.clear();
+    state = State::IDLE;
+}
+
+void StreamLexer::rejectGroup(TokenList &tokens) {
+    std::string replay(1, options.numbers.grouping);
+    replay.append(number, groupStart);
+    number.resize(groupStart);
+    completeNumber(tokens);
+
+    // Relu comme un morceau à part, sans '\n'
+    std::string_view bytes = replay;
+    next(bytes, tokens);
+}
+
+bool StreamLexer::next(std::string_view &bytes, TokenList &tokens) {
+    size_t i = 0;
+    size_t start = 0; // début du mot en cours dans bytes
+    SpanScanner scanner(bytes);
+
+    while (i < bytes.size()) {
+        auto c = static_cast<unsigned char>(bytes[i]);
+        uint8_t cls = BYTE_CLASSES[c];
+
+        // Suite du token en cours; sinon il est terminé et c est relu
+        const NumberFormat &format = options.numbers;
+        switch (state) {
+        case State::NUMBER:
+            if (cls == ByteClass::DIGIT) {
+                size_t end = scanner.span<ByteClass::DIGIT>(i);
+                number.append(bytes.substr(i, end - i));
+                i = end;
+                continue;
+            }
+            if (c == static_cast<unsigned char>(format.decimal)) {
+                number.push_back('.');
+                state = State::FRACTION;
+            } else if (c == static_cast<unsigned char>(format.grouping) &&
+                       c != 0) {
+                groupStart = number.size();
+                state = State::GROUP;
+            } else {
+                completeNumber(tokens);
+                continue;
+            }
+            i++;
+            continue;
+        case State::GROUP:
+            // Exactement trois chiffres après le séparateur de milliers
+            if (cls == ByteClass::DIGIT && number.size() - groupStart < 3) {
+                number.push_back(static_cast<char>(c));
+                i++;
+            } else if (cls != ByteClass::DIGIT &&
+                       number.size() - groupStart == 3) {
+                state = State::NUMBER;
+            } else {
+                rejectGroup(tokens);
+            }
+            continue;
+        case State::FRACTION:
+            if (cls == ByteClass::DIGIT) {
+                size_t end = scanner.span<ByteClass::DIGIT>(i);
+                number.append(bytes.substr(i, end - i));
+                i = end;
+            } else {
+                completeNumber(tokens);
+            }
+            continue;
+        case State::WORD:
+            // Lettres, chiffres, '/' ("km/h", "L/100km") et caractères
+            // UTF-8 ("m³/s")
+            if ((cls & (ByteClass::ALPHA | ByteClass::DIGIT)) != 0) {
+                i = scanner.span<SpanScanner::WORD>(i);
+            } else if (c == '/') {
+                i++;
+            } else if (cls == ByteClass::UTF8_LEAD) {
+                startSequence(c);
+                i++;
+            } else if (cls == ByteClass::UTF8_CONT || c >= 0xC0) {
+                // Octet de suite isolé, C0, C1 ou F5-FF
+                invalid = true;
+                i++;
+            } else {
+                complete(tokens, bytes.substr(start, i - start));
+                start = i;
+            }
+            continue;
+        case State::UTF8:
+            if (cls == ByteClass::UTF8_CONT && c >= utf8Lo && c <= utf8Hi) {
+                utf8Lo = 0x80;
+                utf8Hi = 0xBF;
+                i++;
+                if (--utf8Remaining == 0) {
+                    state = State::WORD;
+                }
+            } else {
+                // Caractère tronqué: c est relu dans le mot
+                invalid = true;
+                state = State::WORD;
+            }
+            continue;
+        case State::IDLE:
+            break;
+        }
+
+        start = i;
+        i++;
+        switch (cls) {
+        case ByteClass::NEWLINE:
+            bytes.remove_prefix(i);
+            return true;
+        case ByteClass::SPACE:
+            i = scanner.span<ByteClass::SPACE>(i);
+            break;
+        case ByteClass::DIGIT:
+            number.push_back(static_cast<char>(c));
+            state = State::NUMBER;
+            break;
+        case ByteClass::ALPHA:
+            state = State::WORD;
+            break;
+        case ByteClass::UTF8_LEAD:
+            startSequence(c);
+            break;
+        case ByteClass::OPERATOR:
+            // '/' collé à un mot fait partie de l'unité, ex. "km/h"
+            tokens.emplace_back(TokenType::OPERATOR, bytes.substr(start, 1),
+                                mr);
+            break;
+        case ByteClass::SEPARATOR:
+            // Séparateur de la liste des unités cibles
+            tokens.emplace_back(TokenType::SEPARATOR, bytes.substr(start, 1),
+                                mr);
+            break;
+        default:
+            tokens.emplace_back(TokenType::UNKNOWN, bytes.substr(start, 1),
+                                mr);
+            break;
+        }
+    }
+
+    // Fin du morceau au milieu d'un mot: seuls ses octets sont gardés (un
+    // nombre est déjà dans number)
+    if (state == State::WORD || state == State::UTF8) {
+        pending.append(bytes.substr(start));
+    }
+    bytes.remove_prefix(bytes.size());
+    return false;
+}
+
+void StreamLexer::finish(TokenList &tokens) {
+    // Un mot coupé avant un chiffre relance le lexer sur la suite
+    while (state != State::IDLE) {
+        switch (state) {
+        case State::GROUP:
+            if (number.size() - groupStart == 3) {
+                state = State::NUMBER;
+            } else {
+                rejectGroup(tokens);
+            }
+            break;
+        case State::NUMBER:
+        case State::FRACTION:
+            completeNumber(tokens);
+            break;
+        case State::UTF8:
+            invalid = true;
+            complete(tokens, {});
+            break;
+        default:
+            complete(tokens, {});
+            break;
+        }
+    }
+}
@@ -1,6 +1,11 @@
 #include "../include/Unit.hpp"
+#include <cstring>
 
-std::unordered_map<std::string, UnitType> UnitSet = {
+// Tables constantes: triées à la compilation, aucune initialisation
+// dynamique au démarrage. Un doublon ou une table mal triée est une erreur
+// de compilation.
+
+constexpr UnitEntry<UnitType> UnitSetRows[] = {
     // WEIGHT / MASSE
     {"kg", UnitType::WEIGHT},
     {"g", UnitType::WEIGHT},
@@ -100,4 +105,684 @@ std::unordered_map<std::string, UnitType> UnitSet = {
     {"psi", UnitType::PRESSURE},
     {"atm", UnitType::PRESSURE},
     {"mmHg", UnitType::PRESSURE},
-    {"inHg", UnitType::PRESSURE}};
+    {"inHg", UnitType::PRESSURE},
+
+    // ÉNERGIE
+    {"J", UnitType::ENERGY},
+    {"kJ", UnitType::ENERGY},
+    {"MJ", UnitType::ENERGY},
+    {"cal", UnitType::ENERGY},  // calorie thermochimique
+    {"kcal", UnitType::ENERGY},
+    {"Wh", UnitType::ENERGY},
+    {"kWh", UnitType::ENERGY},
+    {"BTU", UnitType::ENERGY},  // British thermal unit (IT)
+    {"eV", UnitType::ENERGY},   // électronvolt
+
+    // PUISSANCE
+    {"W", UnitType::POWER},
+    {"kW", UnitType::POWER},
+    {"MW", UnitType::POWER},
+    {"hp", UnitType::POWER},  // horsepower mécanique
+    {"dBW", UnitType::POWER}, // niveau, référence 1 W
+    {"dBm", UnitType::POWER}, // niveau, référence 1 mW
+
+    // DONNÉES
+    {"B", UnitType::DATA}, // octet
+    {"kB", UnitType::DATA},
+    {"MB", UnitType::DATA},
+    {"GB", UnitType::DATA},
+    {"TB", UnitType::DATA},
+    {"KiB", UnitType::DATA},
+    {"MiB", UnitType::DATA},
+    {"GiB", UnitType::DATA},
+    {"TiB", UnitType::DATA},
+    {"bit", UnitType::DATA},
+    {"kbit", UnitType::DATA},
+    {"Mbit", UnitType::DATA},
+    {"Gbit", UnitType::DATA},
+
+    // DÉBIT
+    {"L/s", UnitType::FLOW_RATE},
+    {"L/min", UnitType::FLOW_RATE},
+    {"L/h", UnitType::FLOW_RATE},
+    {"mL/min", UnitType::FLOW_RATE},
+    {"m³/s", UnitType::FLOW_RATE},
+    {"m3/s", UnitType::FLOW_RATE},
+    {"m³/h", UnitType::FLOW_RATE},
+    {"m3/h", UnitType::FLOW_RATE},
+    {"gal/min", UnitType::FLOW_RATE},
+    {"gpm", UnitType::FLOW_RATE}, // gallon US par minute
+
+    // CONSOMMATION
+    {"L/100km", UnitType::FUEL_ECONOMY},
+    {"km/L", UnitType::FUEL_ECONOMY},
+    {"mpg", UnitType::FUEL_ECONOMY}}; // miles par gallon US
+
+constexpr auto UnitSetSorted = sortedTable(UnitSetRows);
+constexpr UnitTable<UnitType> UnitSet(UnitSetSorted);
+
+namespace {
+
+// Définition d'une unité par rapport à l'unité de base de sa dimension,
+// selon kind:
+//   LINEAR, AFFINE  base = x * scale + offset
+//   RECIPROCAL      base = scale / x
+//   LOGARITHMIC     base = scale * 10^(x / decade)
+struct Definition {
+    ConversionKind kind;
+    long double scale;
+    long double offset;
+    long double decade; ///< Valeur par facteur 10 de la base (10 pour dB)
+};
+
+constexpr Definition linear(long double scale) {
+    return Definition{ConversionKind::LINEAR, scale, 0.0L, 0.0L};
+}
+
+constexpr Definition affine(long double scale, long double offset) {
+    return Definition{ConversionKind::AFFINE, scale, offset, 0.0L};
+}
+
+constexpr Definition reciprocal(long double scale) {
+    return Definition{ConversionKind::RECIPROCAL, scale, 0.0L, 0.0L};
+}
+
+constexpr Definition logarithmic(long double reference, long double decade) {
+    return Definition{ConversionKind::LOGARITHMIC, reference, 0.0L, decade};
+}
+
+constexpr UnitEntry<Definition> DefinitionRows[] = {
+    // Définitions exactes (livre, pied, gallon US...) quand elles existent
+
+    // WEIGHT / MASSE (kg)
+    {"kg", linear(1.0L)},
+    {"g", linear(0.001L)},
+    {"mg", linear(0.000001L)},
+    {"t", linear(1000.0L)},          // tonne métrique
+    {"ton", linear(1000.0L)},        // tonne métrique
+    {"lb", linear(0.45359237L)},     // pound
+    {"oz", linear(0.028349523125L)}, // ounce
+    {"st", linear(6.35029318L)},     // stone
+    {"ct", linear(0.0002L)},         // carat
+
+    // DISTANCE / LONGUEUR (m)
+    {"m", linear(1.0L)},
+    {"km", linear(1000.0L)},
+    {"cm", linear(0.01L)},
+    {"mm", linear(0.001L)},
+    {"μm", linear(0.000001L)},    // micromètre
+    {"nm", linear(0.000000001L)}, // nanomètre
+    {"mi", linear(1609.344L)},    // mile
+    {"yd", linear(0.9144L)},      // yard
+    {"ft", linear(0.3048L)},      // foot
+    {"in", linear(0.0254L)},      // inch
+    {"nmi", linear(1852.0L)},     // nautical mile
+
+    // VOLUME (L)
+    {"L", linear(1.0L)},
+    {"l", linear(1.0L)},
+    {"mL", linear(0.001L)},
+    {"ml", linear(0.001L)},
+    {"cL", linear(0.01L)},
+    {"cl", linear(0.01L)},
+    {"dL", linear(0.1L)},
+    {"dl", linear(0.1L)},
+    {"m³", linear(1000.0L)},
+    {"m3", linear(1000.0L)},
+    {"cm³", linear(0.001L)},
+    {"cm3", linear(0.001L)},
+    {"gal", linear(3.785411784L)},       // gallon US
+    {"qt", linear(0.946352946L)},        // quart
+    {"pt", linear(0.473176473L)},        // pint
+    {"cup", linear(0.2365882365L)},
+    {"fl oz", linear(0.0295735295625L)}, // fluid ounce
+    {"tbsp", linear(0.01478676478125L)}, // tablespoon
+    {"tsp", linear(0.00492892159375L)},  // teaspoon
+
+    // TEMPS (s)
+    {"s", linear(1.0L)},
+    {"ms", linear(0.001L)},
+    {"μs", linear(0.000001L)},
+    {"ns", linear(0.000000001L)},
+    {"min", linear(60.0L)},
+    {"h", linear(3600.0L)},
+    {"hr", linear(3600.0L)},
+    {"day", linear(86400.0L)},
+    {"week", linear(604800.0L)},
+    {"month", linear(2592000.0L)}, // 30 jours
+    {"year", linear(31536000.0L)}, // 365 jours
+    {"yr", linear(31536000.0L)},   // 365 jours
+
+    // AIRE / SURFACE (m²)
+    {"m²", linear(1.0L)},
+    {"m2", linear(1.0L)},
+    {"km²", linear(1000000.0L)},
+    {"km2", linear(1000000.0L)},
+    {"cm²", linear(0.0001L)},
+    {"cm2", linear(0.0001L)},
+    {"mm²", linear(0.000001L)},
+    {"mm2", linear(0.000001L)},
+    {"ha", linear(10000.0L)}, // hectare
+    {"acre", linear(4046.8564224L)},
+    {"ft²", linear(0.09290304L)},
+    {"ft2", linear(0.09290304L)},
+    {"yd²", linear(0.83612736L)},
+    {"yd2", linear(0.83612736L)},
+
+    // VITESSE (m/s)
+    {"m/s", linear(1.0L)},
+    {"km/h", linear(1000.0L / 3600.0L)},
+    {"mph", linear(0.44704L)}, // miles per hour
+    {"ft/s", linear(0.3048L)},
+    {"knot", linear(1852.0L / 3600.0L)},
+    {"kn", linear(1852.0L / 3600.0L)},
+
+    // PRESSION (Pa)
+    {"Pa", linear(1.0L)},
+    {"kPa", linear(1000.0L)},
+    {"MPa", linear(1000000.0L)},
+    {"bar", linear(100000.0L)},
+    {"mbar", linear(100.0L)},
+    {"psi", linear(6894.757293168361L)},
+    {"atm", linear(101325.0L)},
+    {"mmHg", linear(133.322387415L)},
+    {"inHg", linear(3386.388640341L)},
+
+    // TEMPÉRATURE (K)
+    {"°C", affine(1.0L, 273.15L)},
+    {"C", affine(1.0L, 273.15L)},
+    {"°F", affine(5.0L / 9.0L, 273.15L - 32.0L * 5.0L / 9.0L)},
+    {"F", affine(5.0L / 9.0L, 273.15L - 32.0L * 5.0L / 9.0L)},
+    {"K", linear(1.0L)}, // Kelvin
+
+    // ÉNERGIE (J)
+    {"J", linear(1.0L)},
+    {"kJ", linear(1000.0L)},
+    {"MJ", linear(1000000.0L)},
+    {"cal", linear(4.184L)}, // calorie thermochimique
+    {"kcal", linear(4184.0L)},
+    {"Wh", linear(3600.0L)},
+    {"kWh", linear(3600000.0L)},
+    {"BTU", linear(1055.05585262L)},
+    {"eV", linear(1.602176634e-19L)},
+
+    // PUISSANCE (W)
+    {"W", linear(1.0L)},
+    {"kW", linear(1000.0L)},
+    {"MW", linear(1000000.0L)},
+    {"hp", linear(745.69987158227022L)}, // 550 ft·lbf/s
+    {"dBW", logarithmic(1.0L, 10.0L)},
+    {"dBm", logarithmic(0.001L, 10.0L)},
+
+    // DONNÉES (B)
+    {"B", linear(1.0L)},
+    {"kB", linear(1000.0L)},
+    {"MB", linear(1000000.0L)},
+    {"GB", linear(1000000000.0L)},
+    {"TB", linear(1000000000000.0L)},
+    {"KiB", linear(1024.0L)},
+    {"MiB", linear(1048576.0L)},
+    {"GiB", linear(1073741824.0L)},
+    {"TiB", linear(1099511627776.0L)},
+    {"bit", linear(0.125L)},
+    {"kbit", linear(125.0L)},
+    {"Mbit", linear(125000.0L)},
+    {"Gbit", linear(125000000.0L)},
+
+    // DÉBIT (L/s)
+    {"L/s", linear(1.0L)},
+    {"L/min", linear(1.0L / 60.0L)},
+    {"L/h", linear(1.0L / 3600.0L)},
+    {"mL/min", linear(0.001L / 60.0L)},
+    {"m³/s", linear(1000.0L)},
+    {"m3/s", linear(1000.0L)},
+    {"m³/h", linear(1000.0L / 3600.0L)},
+    {"m3/h", linear(1000.0L / 3600.0L)},
+    {"gal/min", linear(3.785411784L / 60.0L)},
+    {"gpm", linear(3.785411784L / 60.0L)},
+
+    // CONSOMMATION (L/100km): plus la valeur est grande, moins le
+    // véhicule consomme pour km/L et mpg
+    {"L/100km", linear(1.0L)},
+    {"km/L", reciprocal(100.0L)},
+    {"mpg", reciprocal(100.0L * 3.785411784L / 1.609344L)}};
+
+constexpr auto DefinitionsSorted = sortedTable(DefinitionRows);
+constexpr UnitTable<Definition> Definitions(DefinitionsSorted);
+
+// Unités linéaires seules, déjà triées
+constexpr size_t LINEAR_UNITS = [] {
+    size_t count = 0;
+    for (const auto &row : DefinitionsSorted) {
+        count += row.second.kind == ConversionKind::LINEAR ? 1 : 0;
+    }
+    return count;
+}();
+
+constexpr std::array<UnitEntry<double>, LINEAR_UNITS> linearFactors() {
+    std::array<UnitEntry<double>, LINEAR_UNITS> factors{};
+    size_t next = 0;
+    for (const auto &row : DefinitionsSorted) {
+        if (row.second.kind == ConversionKind::LINEAR) {
+            factors[next++] = {row.first,
+                               static_cast<double>(row.second.scale)};
+        }
+    }
+    return factors;
+}
+
+} // namespace
+
+constexpr auto UnitFactorsSorted = linearFactors();
+constexpr UnitTable<double> UnitFactors(UnitFactorsSorted);
+
+constexpr UnitEntry<std::string_view> UnitAliasesRows[] = {
+    // WEIGHT / MASSE
+    {"kilogram", "kg"},
+    {"kilograms", "kg"},
+    {"kilogramme", "kg"},
+    {"kilogrammes", "kg"},
+    {"gram", "g"},
+    {"grams", "g"},
+    {"gramme", "g"},
+    {"grammes", "g"},
+    {"milligram", "mg"},
+    {"milligrams", "mg"},
+    {"tonne", "t"},
+    {"tonnes", "t"},
+    {"pound", "lb"},
+    {"pounds", "lb"},
+    {"lbs", "lb"},
+    {"ounce", "oz"},
+    {"ounces", "oz"},
+    {"stone", "st"},
+    {"carat", "ct"},
+    {"carats", "ct"},
+
+    // DISTANCE / LONGUEUR
+    {"meter", "m"},
+    {"meters", "m"},
+    {"metre", "m"},
+    {"metres", "m"},
+    {"kilometer", "km"},
+    {"kilometers", "km"},
+    {"kilometre", "km"},
+    {"kilometres", "km"},
+    {"centimeter", "cm"},
+    {"centimeters", "cm"},
+    {"centimetre", "cm"},
+    {"centimetres", "cm"},
+    {"millimeter", "mm"},
+    {"millimeters", "mm"},
+    {"millimetre", "mm"},
+    {"millimetres", "mm"},
+    {"mile", "mi"},
+    {"miles", "mi"},
+    {"yard", "yd"},
+    {"yards", "yd"},
+    {"foot", "ft"},
+    {"feet", "ft"},
+    {"inch", "in"},
+    {"inches", "in"},
+
+    // VOLUME
+    {"liter", "L"},
+    {"liters", "L"},
+    {"litre", "L"},
+    {"litres", "L"},
+    {"milliliter", "mL"},
+    {"milliliters", "mL"},
+    {"millilitre", "mL"},
+    {"millilitres", "mL"},
+    {"gallon", "gal"},
+    {"gallons", "gal"},
+    {"quart", "qt"},
+    {"quarts", "qt"},
+    {"pint", "pt"},
+    {"pints", "pt"},
+    {"cups", "cup"},
+    {"tablespoon", "tbsp"},
+    {"tablespoons", "tbsp"},
+    {"teaspoon", "tsp"},
+    {"teaspoons", "tsp"},
+
+    // TEMPS
+    {"sec", "s"},
+    {"second", "s"},
+    {"seconds", "s"},
+    {"seconde", "s"},
+    {"secondes", "s"},
+    {"minute", "min"},
+    {"minutes", "min"},
+    {"hour", "h"},
+    {"hours", "h"},
+    {"heure", "h"},
+    {"heures", "h"},
+    {"days", "day"},
+    {"jour", "day"},
+    {"jours", "day"},
+    {"weeks", "week"},
+    {"months", "month"},
+    {"years", "year"},
+
+    // TEMPÉRATURE
+    {"celsius", "°C"},
+    {"fahrenheit", "°F"},
+    {"kelvin", "K"},
+
+    // AIRE / SURFACE
+    {"hectare", "ha"},
+    {"hectares", "ha"},
+    {"acres", "acre"},
+
+    // VITESSE
+    {"knots", "knot"},
+    {"kph", "km/h"},
+
+    // PRESSION
+    {"pascal", "Pa"},
+    {"pascals", "Pa"},
+    {"kilopascal", "kPa"},
+    {"kilopascals", "kPa"},
+    {"bars", "bar"},
+    {"millibar", "mbar"},
+    {"millibars", "mbar"},
+
+    // ÉNERGIE
+    {"joule", "J"},
+    {"joules", "J"},
+    {"kilojoule", "kJ"},
+    {"kilojoules", "kJ"},
+    {"calorie", "cal"},
+    {"calories", "cal"},
+    {"kilocalorie", "kcal"},
+    {"kilocalories", "kcal"},
+
+    // PUISSANCE
+    {"watt", "W"},
+    {"watts", "W"},
+    {"kilowatt", "kW"},
+    {"kilowatts", "kW"},
+    {"horsepower", "hp"},
+
+    // DONNÉES
+    {"byte", "B"},
+    {"bytes", "B"},
+    {"octet", "B"},
+    {"octets", "B"},
+    {"kilobyte", "kB"},
+    {"kilobytes", "kB"},
+    {"megabyte", "MB"},
+    {"megabytes", "MB"},
+    {"gigabyte", "GB"},
+    {"gigabytes", "GB"},
+    {"bits", "bit"}};
+
+constexpr auto UnitAliasesSorted = sortedTable(UnitAliasesRows);
+constexpr UnitTable<std::string_view> UnitAliases(UnitAliasesSorted);
+
+namespace {
+
+constexpr Definition definition(std::string_view unit) {
+    const auto *row = Definitions.find(unit);
+    if (row == Definitions.end()) {
+        throw std::logic_error("Unité sans définition");
+    }
+    return row->second;
+}
+
+constexpr size_t UNITS = UnitSetSorted.size();
+static_assert(UNITS <= UINT16_MAX, "UnitId sur 16 bits");
+
+// Place d'une unité dans la table des paires: les paires d'une dimension
+// forment un bloc count × count à partir de block
+struct Slot {
+    size_t block; ///< Début du bloc de la dimension
+    size_t rank;  ///< Rang de l'unité dans sa dimension
+    size_t count; ///< Nombre d'unités de la dimension
+};
+
+constexpr std::array<Slot, UNITS> computeSlots() {
+    std::array<Slot, UNITS> slots{};
+    size_t next = 0;
+    for (size_t i = 0; i < UNITS; i++) {
+        UnitType type = UnitSetSorted[i].second;
+        size_t first = i;
+        size_t rank = 0;
+        size_t count = 0;
+        for (size_t j = 0; j < UNITS; j++) {
+            if (UnitSetSorted[j].second != type) {
+                continue;
+            }
+            first = j < first ? j : first;
+            rank += j < i ? 1 : 0;
+            count++;
+        }
+        size_t block = first == i ? next : slots[first].block;
+        if (first == i) {
+            next += count * count;
+        }
+        slots[i] = Slot{block, rank, count};
+    }
+    return slots;
+}
+
+constexpr auto Slots = computeSlots();
+constexpr size_t PAIRS = [] {
+    size_t total = 0;
+    for (const Slot &slot : Slots) {
+        total += slot.count; // count fois par dimension: count²
+    }
+    return total;
+}();
+
+// Logarithme népérien à la compilation: x = m * 2^e avec m dans [1, 2),
+// puis ln(m) = 2 * atanh((m - 1) / (m + 1))
+constexpr long double LN2 = 0.693147180559945309417232121458176568L;
+constexpr long double LN10 = 2.302585092994045684017960364234883806L;
+
+constexpr long double ln(long double x) {
+    if (!(x > 0.0L)) {
+        throw std::logic_error("Logarithme d'une valeur non positive");
+    }
+    int exponent = 0;
+    while (x >= 2.0L) {
+        x /= 2.0L;
+        exponent++;
+    }
+    while (x < 1.0L) {
+        x *= 2.0L;
+        exponent--;
+    }
+    long double t = (x - 1.0L) / (x + 1.0L);
+    long double term = t;
+    long double sum = 0.0L;
+    for (int k = 1; sum + term / k != sum; k += 2) {
+        sum += term / k;
+        term *= t * t;
+    }
+    return exponent * LN2 + 2.0L * sum;
+}
+
+// Affine ou linéaire: base = x * scale + offset
+constexpr bool isAffine(const Definition &d) {
+    return d.kind == ConversionKind::LINEAR ||
+           d.kind == ConversionKind::AFFINE;
+}
+
+// Coefficients de from vers to, en précision étendue puis un seul arrondi
+// vers double
+constexpr Coefficients compose(const Definition &from, const Definition &to) {
+    auto make = [](ConversionKind kind, long double scale,
+                   long double offset) {
+        if (kind == ConversionKind::AFFINE && offset == 0.0L) {
+            kind = ConversionKind::LINEAR;
+        }
+        return Coefficients{kind, static_cast<double>(scale),
+                            static_cast<double>(offset)};
+    };
+    using K = ConversionKind;
+
+    // to = (x * a_f + b_f - b_t) / a_t
+    if (isAffine(from) && isAffine(to)) {
+        return make(K::AFFINE, from.scale / to.scale,
+                    (from.offset - to.offset) / to.scale);
+    }
+    // Les unités non affines ne côtoient que des unités linéaires
+    if (from.kind == K::AFFINE || to.kind == K::AFFINE) {
+        throw std::logic_error("Unité affine dans une dimension non linéaire");
+    }
+
+    // to = a_t / (a_f * x), ou l'inverse
+    if (from.kind == K::LINEAR && to.kind == K::RECIPROCAL) {
+        return make(K::RECIPROCAL, to.scale / from.scale, 0.0L);
+    }
+    if (from.kind == K::RECIPROCAL && to.kind == K::LINEAR) {
+        return make(K::RECIPROCAL, from.scale / to.scale, 0.0L);
+    }
+    // to = a_t / (a_f / x)
+    if (from.kind == K::RECIPROCAL && to.kind == K::RECIPROCAL) {
+        return make(K::LINEAR, to.scale / from.scale, 0.0L);
+    }
+
+    // to = d_t * log10(x * a_f / a_t)
+    if (from.kind == K::LINEAR && to.kind == K::LOGARITHMIC) {
+        return make(K::LOGARITHMIC, to.decade / LN10,
+                    to.decade * ln(from.scale / to.scale) / LN10);
+    }
+    // to = (a_f / a_t) * 10^(x / d_f)
+    if (from.kind == K::LOGARITHMIC && to.kind == K::LINEAR) {
+        return make(K::EXPONENTIAL, LN10 / from.decade,
+                    ln(from.scale / to.scale));
+    }
+    // to = x * d_t / d_f + d_t * log10(a_f / a_t)
+    if (from.kind == K::LOGARITHMIC && to.kind == K::LOGARITHMIC) {
+        return make(K::AFFINE, to.decade / from.decade,
+                    to.decade * ln(from.scale / to.scale) / LN10);
+    }
+    throw std::logic_error("Combinaison d'unités non prise en charge");
+}
+
+constexpr std::array<Coefficients, PAIRS> computePairs() {
+    std::array<Coefficients, PAIRS> pairs{};
+    for (size_t i = 0; i < UNITS; i++) {
+        Definition from = definition(UnitSetSorted[i].first);
+        for (size_t j = 0; j < UNITS; j++) {
+            if (UnitSetSorted[j].second != UnitSetSorted[i].second) {
+                continue;
+            }
+            Definition to = definition(UnitSetSorted[j].first);
+            pairs[Slots[i].block + Slots[i].rank * Slots[i].count +
+                  Slots[j].rank] = compose(from, to);
+        }
+    }
+    return pairs;
+}
+
+constexpr size_t DIMENSIONS = static_cast<size_t>(UnitType::FUEL_ECONOMY) + 1;
+
+// Unité de base de chaque dimension: la première unité linéaire de facteur 1
+constexpr std::array<std::string_view, DIMENSIONS> computeBaseUnits() {
+    std::array<std::string_view, DIMENSIONS> bases{};
+    for (const auto &[unit, type] : UnitSetSorted) {
+        auto &base = bases[static_cast<size_t>(type)];
+        Definition d = definition(unit);
+        if (base.empty() && d.kind == ConversionKind::LINEAR &&
+            d.scale == 1.0L) {
+            base = unit;
+        }
+    }
+    for (std::string_view base : bases) {
+        if (base.empty()) {
+            throw std::logic_error("Dimension sans unité de base");
+        }
+    }
+    return bases;
+}
+
+constexpr auto BaseUnits = computeBaseUnits();
+
+constexpr auto Pairs = computePairs();
+
+// FNV-1a 64 bits
+uint64_t fnv1a(const void *bytes, size_t size, uint64_t h) {
+    const auto *p = static_cast<const unsigned char *>(bytes);
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ p[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+// Chaîne terminée par '\0': "k" + "g" et "kg" diffèrent
+uint64_t fnv1a(std::string_view s, uint64_t h = 14695981039346656037ULL) {
+    return fnv1a("", 1, fnv1a(s.data(), s.size(), h));
+}
+
+} // namespace
+
+Coefficients pairCoefficients(std::string_view from, std::string_view to) {
+    const auto *f = UnitSet.find(from);
+    const auto *t = UnitSet.find(to);
+    if (f == UnitSet.end() || t == UnitSet.end() || f->second != t->second) {
+        throw std::out_of_range(std::string("Pas de conversion de ")
+                                    .append(from)
+                                    .append(" en ")
+                                    .append(to));
+    }
+    const Slot &a = Slots[static_cast<size_t>(f - UnitSet.begin())];
+    const Slot &b = Slots[static_cast<size_t>(t - UnitSet.begin())];
+    return Pairs[a.block + a.rank * a.count + b.rank];
+}
+
+std::optional<UnitId> unitId(std::string_view unit) {
+    const auto *row = UnitSet.find(unit);
+    if (row == UnitSet.end()) {
+        return std::nullopt;
+    }
+    return static_cast<UnitId>(row - UnitSet.begin());
+}
+
+std::string_view unitName(UnitId id) { return UnitSet.begin()[id].first; }
+
+std::optional<PairId> pairId(UnitId from, UnitId to) {
+    if (from >= UNITS || to >= UNITS ||
+        UnitSetSorted[from].second != UnitSetSorted[to].second) {
+        return std::nullopt;
+    }
+    const Slot &a = Slots[from];
+    return static_cast<PairId>(a.block + a.rank * a.count + Slots[to].rank);
+}
+
+size_t pairCount() { return PAIRS; }
+
+Coefficients pairCoefficients(PairId pair) { return Pairs[pair]; }
+
+std::string_view baseUnit(UnitType type) {
+    return BaseUnits[static_cast<size_t>(type)];
+}
+
+uint64_t registryVersion() {
+    // Somme des empreintes: indépendante de l'ordre d'itération des tables
+    static const uint64_t version = [] {
+        uint64_t sum = 0;
+        for (const auto &[unit, type] : UnitSet) {
+            auto t = static_cast<uint32_t>(type);
+            sum += fnv1a(&t, sizeof t, fnv1a(unit));
+        }
+        for (const auto &[unit, d] : Definitions) {
+            // Coefficients arrondis en double: le padding des long double
+            // n'entre pas dans l'empreinte
+            double fields[] = {static_cast<double>(d.kind),
+                               static_cast<double>(d.scale),
+                               static_cast<double>(d.offset),
+                               static_cast<double>(d.decade)};
+            sum += fnv1a(fields, sizeof fields,
+                         fnv1a(unit, fnv1a("definition")));
+        }
+        for (const auto &[alias, unit] : UnitAliases) {
+            sum += fnv1a(unit, fnv1a(alias, fnv1a("alias")));
+        }
+        return sum;
+    }();
+    return version;
+}
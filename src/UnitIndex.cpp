@@ -0,0 +1,234 @@
+#include "../include/UnitIndex.hpp"
+#include <algorithm>
+#include <array>
+
+namespace {
+
+// Mise en minuscules ASCII (indépendante de la locale)
+std::string foldCase(std::string_view word) {
+    std::string folded(word);
+    for (char &c : folded) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return folded;
+}
+
+// Décode une chaîne UTF-8 en points de code (octets invalides gardés tels
+// quels)
+std::u32string decodeUtf8(std::string_view s) {
+    std::u32string out;
+    out.reserve(s.size());
+    size_t i = 0;
+    while (i < s.size()) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        size_t len = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+        char32_t cp = len == 1 ? c : c & (0x7F >> len);
+        for (size_t k = 1; k < len; k++) {
+            if (i + k >= s.size() ||
+                (static_cast<unsigned char>(s[i + k]) & 0xC0) != 0x80) {
+                len = 1;
+                cp = c;
+                break;
+            }
+            cp = (cp << 6) | (static_cast<unsigned char>(s[i + k]) & 0x3F);
+        }
+        out.push_back(cp);
+        i += len;
+    }
+    return out;
+}
+
+} // namespace
+
+UnitIndex::UnitIndex(
+    const UnitTable<UnitType> &units,
+    const UnitTable<std::string_view> &aliases) {
+    entries.reserve(units.size() + aliases.size());
+
+    for (const auto &[spelling, type] : units) {
+        insert(spelling, spelling);
+
+        std::string key = foldCase(spelling);
+        auto [it, inserted] = folded.emplace(key, spelling);
+        // Collision de casse (mL/ml, L/l): on garde l'orthographe déjà en
+        // minuscules, sinon la recherche est ambiguë
+        if (!inserted && it->second != key) {
+            it->second = spelling == key ? spelling : std::string_view();
+        }
+    }
+
+    for (const auto &[alias, canonical] : aliases) {
+        insert(alias, canonical);
+        folded.emplace(foldCase(alias), canonical);
+    }
+}
+
+const UnitIndex &UnitIndex::global() {
+    static const UnitIndex index(UnitSet, UnitAliases);
+    return index;
+}
+
+template <typename F>
+void UnitIndex::forEachDeletion(std::u32string_view s, size_t maxDeletes,
+                                F &&f) {
+    constexpr size_t NONE = static_cast<size_t>(-1);
+
+    // FNV-1a de la chaîne privée des positions skip1 et skip2
+    auto hashWithout = [s](size_t skip1, size_t skip2) {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < s.size(); i++) {
+            if (i != skip1 && i != skip2) {
+                h = (h ^ s[i]) * 1099511628211ULL;
+            }
+        }
+        return h;
+    };
+
+    f(hashWithout(NONE, NONE));
+    for (size_t i = 0; maxDeletes >= 1 && i < s.size(); i++) {
+        f(hashWithout(i, NONE));
+        for (size_t j = i + 1; maxDeletes >= 2 && j < s.size(); j++) {
+            f(hashWithout(i, j));
+        }
+    }
+}
+
+void UnitIndex::insert(std::string_view spelling, std::string_view canonical) {
+    auto id = static_cast<uint32_t>(entries.size());
+    entries.push_back(Entry{decodeUtf8(spelling), canonical});
+    longest = std::max(longest, entries.back().spelling.size());
+
+    forEachDeletion(entries.back().spelling, MAX_DISTANCE, [&](uint64_t h) {
+        auto &ids = deletions[h];
+        if (ids.empty() || ids.back() != id) {
+            ids.push_back(id);
+        }
+    });
+}
+
+std::vector<UnitIndex::Match> UnitIndex::query(std::string_view word,
+                                               size_t maxDistance) const {
+    maxDistance = std::min(maxDistance, MAX_DISTANCE);
+    // Plus long que toute orthographe + maxDistance: aucune ne peut être à
+    // portée, et les variantes coûteraient O(n³) (un code point fait au
+    // plus 4 octets, au moins 1)
+    if (word.size() > 4 * (longest + maxDistance)) {
+        return {};
+    }
+    std::u32string decoded = decodeUtf8(word);
+    if (decoded.size() > longest + maxDistance) {
+        return {};
+    }
+
+    // Candidats: entrées partageant une variante par suppression
+    std::vector<uint32_t> candidates;
+    forEachDeletion(decoded, maxDistance, [&](uint64_t h) {
+        auto it = deletions.find(h);
+        if (it != deletions.end()) {
+            candidates.insert(candidates.end(), it->second.begin(),
+                              it->second.end());
+        }
+    });
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    // Vérification exacte
+    std::vector<Match> matches;
+    for (uint32_t id : candidates) {
+        size_t d = distance(decoded, entries[id].spelling);
+        if (d <= maxDistance) {
+            matches.push_back(Match{entries[id].canonical, d});
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(),
+              [](const Match &a, const Match &b) {
+                  return a.distance != b.distance ? a.distance < b.distance
+                                                  : a.unit < b.unit;
+              });
+    return matches;
+}
+
+std::optional<std::string_view>
+UnitIndex::resolve(std::string_view word) const {
+    auto unit = UnitSet.find(word);
+    if (unit != UnitSet.end()) {
+        return unit->first;
+    }
+    auto alias = UnitAliases.find(word);
+    if (alias != UnitAliases.end()) {
+        return alias->second;
+    }
+
+    auto it = folded.find(foldCase(word));
+    if (it == folded.end() || it->second.empty()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::vector<std::string_view> UnitIndex::suggest(std::string_view word,
+                                                 size_t maxDistance,
+                                                 size_t maxResults) const {
+    std::vector<std::string_view> result;
+    for (const Match &match : query(word, maxDistance)) {
+        if (result.size() == maxResults) {
+            break;
+        }
+        if (std::find(result.begin(), result.end(), match.unit) ==
+            result.end()) {
+            result.push_back(match.unit);
+        }
+    }
+    return result;
+}
+
+std::optional<std::string_view>
+UnitIndex::closest(std::string_view word, size_t maxDistance) const {
+    auto matches = query(word, maxDistance);
+    if (matches.empty()) {
+        return std::nullopt;
+    }
+
+    // Plusieurs unités distinctes à la même distance minimale: ambigu
+    for (const Match &match : matches) {
+        if (match.distance != matches.front().distance) {
+            break;
+        }
+        if (match.unit != matches.front().unit) {
+            return std::nullopt;
+        }
+    }
+    return matches.front().unit;
+}
+
+size_t UnitIndex::distance(std::string_view a, std::string_view b) {
+    return distance(decodeUtf8(a), decodeUtf8(b));
+}
+
+size_t UnitIndex::distance(std::u32string_view a, std::u32string_view b) {
+    // Les unités sont courtes: une ligne de la matrice tient sur la pile
+    constexpr size_t MAX_LEN = 64;
+    if (a.size() > MAX_LEN || b.size() > MAX_LEN) {
+        return std::max(a.size(), b.size());
+    }
+
+    std::array<size_t, MAX_LEN + 1> row;
+    for (size_t j = 0; j <= b.size(); j++) {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); i++) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            size_t above = row[j];
+            size_t cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + cost});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
@@ -0,0 +1,159 @@
+#include "../include/AsyncIO.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+// Fichier temporaire contenant text, ouvert en lecture
+int tempFile(const std::string &text) {
+    char path[] = "/tmp/test_asyncio_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    unlink(path);
+    assert(write(fd, text.data(), text.size()) ==
+           static_cast<ssize_t>(text.size()));
+    lseek(fd, 0, SEEK_SET);
+    return fd;
+}
+
+// Lignes de longueurs variées, taille non multiple des blocs
+std::string sample(size_t bytes) {
+    std::string text;
+    for (size_t i = 0; text.size() < bytes; i++) {
+        text.append("convert ").append(std::to_string(i * 7919 % 100003));
+        text.append(i % 3 == 0 ? " km/h to mph\n" : " μm to nm, in\n");
+    }
+    text.resize(bytes);
+    return text;
+}
+
+std::string readAll(AsyncIO &io) {
+    std::string text;
+    std::string_view block;
+    while (io.read(block)) {
+        assert(!block.empty());
+        text.append(block);
+    }
+    // La fin reste la fin
+    assert(!io.read(block));
+    return text;
+}
+
+void test_read_file() {
+    std::cout << "Test: Blocks of a file, in order\n";
+    std::string text = sample(1000003);
+    for (bool ring : {true, false}) {
+        int fd = tempFile(text);
+        AsyncIO io(fd, STDOUT_FILENO, ring, 4096, 4);
+        std::cout << (io.usesRing() ? "  io_uring\n" : "  read()\n");
+        assert(readAll(io) == text);
+
+        // Depuis la position courante du descripteur
+        lseek(fd, 100, SEEK_SET);
+        AsyncIO tail(fd, STDOUT_FILENO, ring, 4096, 3);
+        assert(readAll(tail) == text.substr(100));
+        close(fd);
+    }
+
+    // Fichier vide
+    int empty = tempFile("");
+    AsyncIO io(empty, STDOUT_FILENO);
+    assert(readAll(io).empty());
+    close(empty);
+    std::cout << "✓ File read test passed\n\n";
+}
+
+void test_read_pipe() {
+    std::cout << "Test: Blocks of a pipe\n";
+    // Moins que la capacité d'un tube: tout est écrit avant la lecture
+    std::string text = sample(40000);
+    for (bool ring : {true, false}) {
+        int fds[2];
+        assert(pipe(fds) == 0);
+        assert(write(fds[1], text.data(), text.size()) ==
+               static_cast<ssize_t>(text.size()));
+        close(fds[1]);
+        AsyncIO io(fds[0], STDOUT_FILENO, ring, 1000, 4);
+        assert(readAll(io) == text);
+        close(fds[0]);
+    }
+    std::cout << "✓ Pipe read test passed\n\n";
+}
+
+void test_write() {
+    std::cout << "Test: Buffered output\n";
+    std::string big = sample(300000);
+    for (bool ring : {true, false}) {
+        int fd = tempFile("");
+        std::string expected;
+        {
+            AsyncIO io(STDIN_FILENO, fd, ring, 4096, 2);
+            std::ostream out(&io);
+            for (int i = 0; i < 5000; i++) {
+                out << i << " m = " << i * 3.28084 << " ft" << std::endl;
+            }
+            out << big;
+            io.finish();
+        }
+        // Le flux d'octets attendu, par le même formatage
+        FILE *reference = std::tmpfile();
+        for (int i = 0; i < 5000; i++) {
+            std::fprintf(reference, "%d m = %g ft\n", i, i * 3.28084);
+        }
+        long size = std::ftell(reference);
+        expected.resize(static_cast<size_t>(size));
+        std::rewind(reference);
+        assert(std::fread(expected.data(), 1, expected.size(), reference) ==
+               expected.size());
+        std::fclose(reference);
+        expected += big;
+
+        lseek(fd, 0, SEEK_SET);
+        AsyncIO check(fd, STDOUT_FILENO, false);
+        std::string_view block;
+        std::string got;
+        while (check.read(block)) {
+            got.append(block);
+        }
+        assert(got == expected);
+        close(fd);
+    }
+    std::cout << "✓ Buffered output test passed\n\n";
+}
+
+void test_errors() {
+    std::cout << "Test: Read errors\n";
+    // Un répertoire ne se lit pas (EISDIR)
+    int dir = open("/tmp", O_RDONLY | O_DIRECTORY);
+    assert(dir >= 0);
+    for (bool ring : {true, false}) {
+        AsyncIO io(dir, STDOUT_FILENO, ring);
+        std::string_view block;
+        bool thrown = false;
+        try {
+            io.read(block);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    close(dir);
+    std::cout << "✓ Read errors test passed\n\n";
+}
+
+int main() {
+    std::cout << "=== AsyncIO Tests ===\n\n";
+
+    test_read_file();
+    test_read_pipe();
+    test_write();
+    test_errors();
+
+    std::cout << "=== All AsyncIO tests passed! ===\n";
+    return 0;
+}
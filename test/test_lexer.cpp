@@ -1,6 +1,15 @@
+#include "../include/ByteClass.hpp"
 #include "../include/Lexer.hpp"
+#include "../include/StreamLexer.hpp"
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef>
 #include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
 
 void print_token(const Token &token) {
     std::string type_str;
@@ -14,6 +23,12 @@ void print_token(const Token &token) {
     case TokenType::DECIMAL:
         type_str = "DECIMAL";
         break;
+    case TokenType::OPERATOR:
+        type_str = "OPERATOR";
+        break;
+    case TokenType::SEPARATOR:
+        type_str = "SEPARATOR";
+        break;
     case TokenType::UNKNOWN:
         type_str = "UNKNOWN";
         break;
@@ -103,6 +118,342 @@ void test_mixed() {
     std::cout << "✓ Mixed input test passed\n\n";
 }
 
+void test_operators() {
+    std::cout << "Test: Arithmetic operators\n";
+    Lexer lexer("(3 kg + 500 g) * 2 - 1 km/h / 4");
+    auto tokens = lexer.lex();
+
+    assert(tokens.size() == 14);
+    assert(tokens[0].type == TokenType::OPERATOR);
+    assert(tokens[0].value == "(");
+    assert(tokens[3].type == TokenType::OPERATOR);
+    assert(tokens[3].value == "+");
+    assert(tokens[6].value == ")");
+    assert(tokens[7].value == "*");
+    assert(tokens[9].value == "-");
+    // '/' collé au mot fait partie de l'unité
+    assert(tokens[11].type == TokenType::UNIT);
+    assert(tokens[11].value == "km/h");
+    assert(tokens[12].type == TokenType::OPERATOR);
+    assert(tokens[12].value == "/");
+    std::cout << "✓ Operators test passed\n\n";
+}
+
+void test_target_list() {
+    std::cout << "Test: Target unit list\n";
+    Lexer lexer("to m/s, mph,knot");
+    auto tokens = lexer.lex();
+
+    assert(tokens.size() == 6);
+    assert(tokens[1].type == TokenType::UNIT);
+    assert(tokens[2].type == TokenType::SEPARATOR);
+    assert(tokens[2].value == ",");
+    assert(tokens[3].value == "mph");
+    assert(tokens[4].type == TokenType::SEPARATOR);
+    assert(tokens[5].value == "knot");
+    std::cout << "✓ Target list test passed\n\n";
+}
+
+void test_arena() {
+    std::cout << "Test: Tokens allocated from an arena\n";
+    // Pas de repli sur le tas: toute allocation hors du buffer lève
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource arena(
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+    for (int batch = 0; batch < 100; batch++) {
+        Lexer lexer("convert 1.3 kilogrammes to lb", &arena);
+        auto tokens = lexer.lex();
+
+        assert(tokens.size() == 5);
+        assert(tokens.get_allocator().resource() == &arena);
+        assert(tokens[2].type == TokenType::UNKNOWN);
+        assert(tokens[2].value == "kilogrammes");
+        assert(tokens[2].value.get_allocator().resource() == &arena);
+
+        // Reset entre deux lots: le buffer est réutilisé
+        arena.release();
+    }
+    std::cout << "✓ Arena test passed\n\n";
+}
+
+void test_lenient() {
+    std::cout << "Test: Lenient unit matching\n";
+    LexerOptions options;
+    options.lenient = true;
+
+    Lexer lexer("convert 3 Feet to KPA kgg xyz",
+                std::pmr::get_default_resource(), options);
+    auto tokens = lexer.lex();
+
+    assert(tokens.size() == 7);
+    assert(tokens[2].type == TokenType::UNIT);
+    assert(tokens[2].value == "ft");
+    assert(tokens[4].type == TokenType::UNIT);
+    assert(tokens[4].value == "kPa");
+    assert(tokens[5].type == TokenType::UNIT);
+    assert(tokens[5].value == "kg");
+    assert(tokens[6].type == TokenType::UNKNOWN);
+
+    // Sans le mode tolérant, rien n'est corrigé
+    Lexer strict("Feet");
+    auto strictTokens = strict.lex();
+    assert(strictTokens[0].type == TokenType::UNKNOWN);
+    std::cout << "✓ Lenient test passed\n\n";
+}
+
+bool sameTokens(const TokenList &a, const TokenList &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].type != b[i].type || a[i].value != b[i].value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Lignes lexées par StreamLexer, l'entrée découpée en morceaux de size
+// octets à partir de l'offset first
+std::vector<TokenList> lexChunks(std::string_view input, size_t first,
+                                 size_t size, LexerOptions options = {}) {
+    StreamLexer lexer(std::pmr::get_default_resource(), options);
+    std::vector<TokenList> lines;
+    TokenList line;
+    for (size_t at = 0; at < input.size();) {
+        size_t n = at == 0 ? first : size;
+        std::string_view bytes = input.substr(at, n);
+        at += bytes.size();
+        while (lexer.next(bytes, line)) {
+            lines.push_back(line);
+            line.clear();
+        }
+    }
+    lexer.finish(line);
+    if (!line.empty()) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+void test_stream_split() {
+    std::cout << "Test: Input split across chunks\n";
+    std::string input = "convert 12.5 μm to nm\n"
+                        "convert 3 m² + 4.25 m2 to ft²\r\n"
+                        "\n"
+                        "convert -40 ℃ to °F, K\n"
+                        "convert 100 km/h to mph ? \n"
+                        "convert 8 L/100km to mpg, m³/s\xE2\x82\n"
+                        "convert 1.5.2 kgg to lb";
+
+    // Référence: chaque ligne lexée en entier
+    std::vector<TokenList> expected;
+    for (size_t start = 0; start < input.size();) {
+        size_t end = std::min(input.find('\n', start), input.size());
+        Lexer lexer(std::string_view(input).substr(start, end - start));
+        TokenList tokens = lexer.lex();
+        if (!tokens.empty()) {
+            expected.push_back(std::move(tokens));
+        }
+        start = end + 1;
+    }
+    assert(expected.size() == 6);
+    assert(expected[0][2].value == "μm");
+    assert(expected[1][2].value == "m²" && expected[1][7].value == "ft²");
+    assert(expected[2][3].value == "°C");
+    assert(expected[4][2].value == "L/100km");
+    assert(expected[4][6].type == TokenType::UNKNOWN);
+
+    // Toutes les coupures possibles, dont au milieu d'un caractère UTF-8,
+    // et des morceaux d'un octet
+    for (size_t first = 1; first <= input.size(); first++) {
+        for (size_t size : {size_t(1), size_t(3), size_t(7), input.size()}) {
+            std::vector<TokenList> lines = lexChunks(input, first, size);
+            // Les lignes vides ne produisent aucun token
+            lines.erase(std::remove_if(lines.begin(), lines.end(),
+                                       [](const TokenList &l) {
+                                           return l.empty();
+                                       }),
+                        lines.end());
+            assert(lines.size() == expected.size());
+            for (size_t i = 0; i < lines.size(); i++) {
+                assert(sameTokens(lines[i], expected[i]));
+            }
+        }
+    }
+    std::cout << "✓ Stream split test passed\n\n";
+}
+
+void test_utf8_units() {
+    std::cout << "Test: UTF-8 units and look-alike characters\n";
+    auto lex = [](std::string_view text) {
+        Lexer lexer(text);
+        return lexer.lex();
+    };
+    auto single = [&](std::string_view text, TokenType type,
+                      std::string_view value) {
+        TokenList tokens = lex(text);
+        return tokens.size() == 1 && tokens[0].type == type &&
+               tokens[0].value == value;
+    };
+
+    // Chiffres, exposants et '/' dans les unités
+    assert(single("m3", TokenType::UNIT, "m3"));
+    assert(single("m³/s", TokenType::UNIT, "m³/s"));
+    assert(single("L/100km", TokenType::UNIT, "L/100km"));
+    assert(single("cm²", TokenType::UNIT, "cm²"));
+
+    // Variantes ramenées au symbole du registre
+    assert(single("µm", TokenType::UNIT, "μm")); // U+00B5
+    assert(single("μs", TokenType::UNIT, "μs")); // U+03BC
+    assert(single("ºF", TokenType::UNIT, "°F"));
+    assert(single("˚C", TokenType::UNIT, "°C"));
+    assert(single("℃", TokenType::UNIT, "°C"));
+    assert(single("\u212A", TokenType::UNIT, "K"));
+    assert(single("mℓ", TokenType::UNIT, "mL"));
+
+    // Un mot qui n'est pas une unité s'arrête avant ses chiffres
+    TokenList tokens = lex("5ft11in");
+    assert(tokens.size() == 4);
+    assert(tokens[1].value == "ft" && tokens[2].value == "11");
+    assert(tokens[3].type == TokenType::UNIT && tokens[3].value == "in");
+
+    // UTF-8 invalide: forme trop longue, surrogate, au-delà de U+10FFFF,
+    // séquence tronquée, octet de suite isolé
+    for (std::string_view bad :
+         {"m\xC0\xAF", "m\xE0\x80\x80", "m\xED\xA0\x80", "m\xF4\x90\x80\x80",
+          "m\xE2\x84", "\xE2\x84m", "m\x80", "m\xFF"}) {
+        tokens = lex(bad);
+        assert(!tokens.empty());
+        assert(std::none_of(tokens.begin(), tokens.end(), [](const Token &t) {
+            return t.type == TokenType::UNIT;
+        }));
+    }
+    assert(single("\xB2", TokenType::UNKNOWN, "\xB2"));
+    std::cout << "✓ UTF-8 units test passed\n\n";
+}
+
+void test_long_words() {
+    std::cout << "Test: Long words split before their digits\n";
+    // Chaque coupure reprend dans le mot, sans recopier la suite: un mot
+    // de 400 000 octets se lexe en temps linéaire
+    std::string word;
+    for (int i = 0; i < 200000; i++) {
+        word.append("a1");
+    }
+    Lexer lexer(word);
+    TokenList tokens = lexer.lex();
+    assert(tokens.size() == 400000);
+    assert(tokens[0].type == TokenType::UNKNOWN && tokens[0].value == "a");
+    assert(tokens[1].type == TokenType::DECIMAL && tokens[1].value == "1");
+    assert(tokens.back().type == TokenType::DECIMAL);
+
+    // Même découpe qu'en lexant chaque morceau: chiffres finaux suivis
+    // d'une fraction, '/' et unité après des chiffres, coupures du flux
+    std::string input = "ab12.5 x1L/100km ab1/2cd 5ft11in xyz" + word;
+    Lexer whole(input);
+    TokenList expected = whole.lex();
+    assert(expected[1].value == "12.5");
+    assert(expected[4].type == TokenType::UNIT &&
+           expected[4].value == "L/100km");
+    assert(expected[7].type == TokenType::OPERATOR);
+    for (size_t size : {size_t(1), size_t(5), size_t(4096)}) {
+        std::vector<TokenList> lines = lexChunks(input, size, size);
+        assert(lines.size() == 1 && sameTokens(lines[0], expected));
+    }
+    std::cout << "✓ Long words test passed\n\n";
+}
+
+void test_byte_spans() {
+    std::cout << "Test: Vectorized spans match the byte loop\n";
+    // Toutes les valeurs d'octets, dans des runs de longueurs variées
+    std::string bytes;
+    for (int length = 0; length < 40; length++) {
+        for (int c = 0; c < 256; c += 7) {
+            char run = "a Z9\t"[length % 5];
+            bytes.append(static_cast<size_t>(length), run);
+            bytes.push_back(static_cast<char>(c));
+        }
+    }
+    // Dans l'ordre, puis en revenant en arrière (changement de bloc)
+    SpanScanner scanner(bytes);
+    for (size_t k = 0; k <= 2 * bytes.size(); k++) {
+        size_t from = k <= bytes.size() ? k : 2 * bytes.size() - k;
+        assert(scanner.span<ByteClass::DIGIT>(from) ==
+               spanScalar<ByteClass::DIGIT>(bytes, from));
+        assert(scanner.span<ByteClass::SPACE>(from) ==
+               spanScalar<ByteClass::SPACE>(bytes, from));
+        assert(scanner.span<SpanScanner::WORD>(from) ==
+               spanScalar<SpanScanner::WORD>(bytes, from));
+    }
+    // Run de plus d'un bloc
+    std::string digits(200, '7');
+    SpanScanner longRun(digits);
+    assert(longRun.span<ByteClass::DIGIT>(3) == digits.size());
+    assert(byteClass('\n') == ByteClass::NEWLINE);
+    assert(byteClass('\xC1') == 0 && byteClass('\xF5') == 0);
+    std::cout << "✓ Byte spans test passed\n\n";
+}
+
+void test_number_format() {
+    std::cout << "Test: Decimal and grouping separators\n";
+    LexerOptions options;
+    options.numbers = NumberFormat{',', ' '};
+    std::string input = "convert 1 234,56 m to ft\n"
+                        "convert 5 ft 11 in to cm\n"
+                        "1 2345 12 345 678,5 1 23";
+
+    auto lex = [&](std::string_view text) {
+        Lexer lexer(text, std::pmr::get_default_resource(), options);
+        return lexer.lex();
+    };
+
+    // Nombre réécrit avec '.' et sans séparateur de milliers
+    auto tokens = lex("convert 1 234,56 m to ft");
+    assert(tokens.size() == 5);
+    assert(tokens[1].type == TokenType::DECIMAL);
+    assert(tokens[1].value == "1234.56");
+    assert(decimalValue(tokens[1].value) == 1234.56f);
+
+    // Un séparateur suivi d'autre chose que trois chiffres sépare deux
+    // nombres
+    tokens = lex("convert 5 ft 11 in to cm");
+    assert(tokens.size() == 7);
+    assert(tokens[1].value == "5" && tokens[3].value == "11");
+    tokens = lex("1 2345 12 345 678,5 1 23");
+    assert(tokens.size() == 5);
+    assert(tokens[0].value == "1");
+    assert(tokens[1].value == "2345");
+    assert(tokens[2].value == "12345678.5");
+    assert(tokens[3].value == "1" && tokens[4].value == "23");
+
+    // Le format par défaut ne change pas: ',' sépare la liste des cibles
+    Lexer plain("1,5");
+    auto plainTokens = plain.lex();
+    assert(plainTokens.size() == 3);
+    assert(plainTokens[1].type == TokenType::SEPARATOR);
+
+    // Mêmes tokens quelle que soit la coupure, même au milieu d'un groupe
+    std::vector<TokenList> expected = lexChunks(input, input.size(), 1,
+                                                options);
+    assert(expected.size() == 3);
+    for (size_t first = 1; first <= input.size(); first++) {
+        for (size_t size : {size_t(1), size_t(2), size_t(5)}) {
+            std::vector<TokenList> lines =
+                lexChunks(input, first, size, options);
+            assert(lines.size() == expected.size());
+            for (size_t i = 0; i < lines.size(); i++) {
+                assert(sameTokens(lines[i], expected[i]));
+            }
+        }
+    }
+
+    assert(!decimalValue("1e99").has_value());
+    assert(!decimalValue("1.5.2").has_value());
+    std::cout << "✓ Number format test passed\n\n";
+}
+
 int main() {
     std::cout << "=== Lexer Tests ===\n\n";
 
@@ -112,6 +463,15 @@ int main() {
         test_whitespace();
         test_unknown_tokens();
         test_mixed();
+        test_operators();
+        test_target_list();
+        test_arena();
+        test_lenient();
+        test_stream_split();
+        test_utf8_units();
+        test_long_words();
+        test_byte_spans();
+        test_number_format();
 
         std::cout << "=== All tests passed! ===\n";
         return 0;
@@ -1,7 +1,12 @@
 #include "../include/Lexer.hpp"
 #include "../include/Parser.hpp"
+#include <array>
+#include <iterator>
 #include <cassert>
+#include <cstddef>
 #include <iostream>
+#include <memory_resource>
+#include <string>
 
 void test_parse_valid_conversion() {
     std::cout << "Test: Valid conversion request\n";
@@ -107,7 +112,7 @@ void test_parse_extra_tokens() {
 
 void test_parse_empty_tokens() {
     std::cout << "Test: Empty token list\n";
-    std::vector<Token> tokens;
+    TokenList tokens;
 
     Parser parser(tokens);
     auto result = parser.parse();
@@ -170,6 +175,163 @@ void test_parse_different_units() {
     std::cout << "✓ Different units test passed\n\n";
 }
 
+void test_parse_mixed_units() {
+    std::cout << "Test: Juxtaposed quantities\n";
+    Lexer lexer("convert 5 ft 11 in to cm");
+    auto tokens = lexer.lex();
+
+    Parser parser(tokens);
+    auto result = parser.parse();
+
+    assert(result.has_value());
+    assert(result->value == 5.0f);
+    assert(result->fromUnit == "ft");
+    assert(result->toUnit == "cm");
+
+    // 5 ft 11 in → 5 ft + 11 in
+    const auto &expr = result->expression;
+    assert(expr.size() == 5);
+    assert(expr[0].kind == ExprNode::Kind::NUMBER && expr[0].value == 5.0f);
+    assert(expr[1].kind == ExprNode::Kind::UNIT && expr[1].unit == "ft");
+    assert(expr[2].kind == ExprNode::Kind::NUMBER && expr[2].value == 11.0f);
+    assert(expr[3].kind == ExprNode::Kind::UNIT && expr[3].unit == "in");
+    assert(expr[4].kind == ExprNode::Kind::ADD);
+    std::cout << "✓ Juxtaposed quantities test passed\n\n";
+}
+
+void test_parse_arithmetic() {
+    std::cout << "Test: Arithmetic expression\n";
+    Lexer lexer("convert 2 * (3 kg - 500 g) + 1 lb to g");
+    auto tokens = lexer.lex();
+
+    Parser parser(tokens);
+    auto result = parser.parse();
+    assert(result.has_value());
+
+    // Postfixe: 2 3 kg 500 g - * 1 lb +
+    using K = ExprNode::Kind;
+    const K expected[] = {K::NUMBER, K::NUMBER, K::UNIT, K::NUMBER,
+                          K::UNIT,   K::SUB,    K::MUL,  K::NUMBER,
+                          K::UNIT,   K::ADD};
+    const auto &expr = result->expression;
+    assert(expr.size() == std::size(expected));
+    for (size_t i = 0; i < expr.size(); i++) {
+        assert(expr[i].kind == expected[i]);
+    }
+    assert(result->value == 3.0f);
+    assert(result->fromUnit == "kg");
+    std::cout << "✓ Arithmetic expression test passed\n\n";
+}
+
+void test_parse_negative_value() {
+    std::cout << "Test: Negative value\n";
+    Lexer lexer("convert -40 C to F");
+    auto tokens = lexer.lex();
+
+    Parser parser(tokens);
+    auto result = parser.parse();
+
+    assert(result.has_value());
+    assert(result->value == -40.0f);
+    assert(result->fromUnit == "C");
+    assert(result->expression.size() == 3);
+    assert(result->expression[2].kind == ExprNode::Kind::NEG);
+    std::cout << "✓ Negative value test passed\n\n";
+}
+
+void test_parse_target_list() {
+    std::cout << "Test: Several target units\n";
+    Lexer lexer("convert 100 km/h to m/s, mph, knot");
+    auto tokens = lexer.lex();
+
+    Parser parser(tokens);
+    auto result = parser.parse();
+
+    assert(result.has_value());
+    assert(result->toUnit == "m/s");
+    assert(result->toUnits.size() == 3);
+    assert(result->toUnits[1] == "mph");
+    assert(result->toUnits[2] == "knot");
+
+    // Liste mal formée
+    const char *inputs[] = {"convert 1 km to m,", "convert 1 km to m, , ft",
+                            "convert 1 km to , m"};
+    for (const char *input : inputs) {
+        Lexer bad(input);
+        auto badTokens = bad.lex();
+        Parser badParser(badTokens);
+        assert(!badParser.parse().has_value());
+    }
+    std::cout << "✓ Target list test passed\n\n";
+}
+
+void test_parse_invalid_expressions() {
+    std::cout << "Test: Invalid expressions\n";
+    const char *inputs[] = {"convert (3 kg to g", "convert 3 kg + to g",
+                            "convert 2 * 3 to g", "convert 3 kg 500 to g"};
+    for (const char *input : inputs) {
+        Lexer lexer(input);
+        auto tokens = lexer.lex();
+        Parser parser(tokens);
+        assert(!parser.parse().has_value());
+    }
+    std::cout << "✓ Invalid expressions test passed\n\n";
+}
+
+void test_parse_nesting_depth() {
+    std::cout << "Test: Nesting depth\n";
+    auto parses = [](const std::string &input) {
+        Lexer lexer(input);
+        auto tokens = lexer.lex();
+        Parser parser(tokens);
+        return parser.parse().has_value();
+    };
+    auto nested = [](size_t levels, const char *open, const char *close) {
+        std::string input = "convert ";
+        for (size_t i = 0; i < levels; i++) {
+            input += open;
+        }
+        input += "1 kg";
+        for (size_t i = 0; close[0] != '\0' && i < levels; i++) {
+            input += close;
+        }
+        return input + " to lb";
+    };
+    assert(parses(nested(16, "(", ")")));
+    assert(!parses(nested(17, "(", ")")));
+    assert(parses(nested(16, "- ", "")));
+    assert(!parses(nested(17, "- ", "")));
+    assert(parses(nested(8, "- (", ")")));
+    assert(!parses(nested(9, "- (", ")")));
+
+    // Sans borne, la récursion épuisait la pile
+    assert(!parses(nested(200000, "(", "")));
+    assert(!parses(nested(200000, "- ", "")));
+    std::cout << "✓ Nesting depth test passed\n\n";
+}
+
+void test_parse_with_arena() {
+    std::cout << "Test: Parsing into an arena\n";
+    // Pas de repli sur le tas: toute allocation hors du buffer lève
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource arena(
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+    Lexer lexer("convert 2.5 km/h to mph", &arena);
+    auto tokens = lexer.lex();
+
+    Parser parser(tokens, &arena);
+    auto result = parser.parse();
+
+    assert(result.has_value());
+    assert(result->value == 2.5f);
+    assert(result->fromUnit == "km/h");
+    assert(result->toUnit == "mph");
+    assert(result->fromUnit.get_allocator().resource() == &arena);
+    assert(result->toUnit.get_allocator().resource() == &arena);
+    std::cout << "✓ Arena parsing test passed\n\n";
+}
+
 int main() {
     std::cout << "=== Parser Tests ===\n\n";
 
@@ -185,6 +347,13 @@ int main() {
     test_parse_small_value();
     test_parse_large_value();
     test_parse_different_units();
+    test_parse_mixed_units();
+    test_parse_arithmetic();
+    test_parse_negative_value();
+    test_parse_target_list();
+    test_parse_invalid_expressions();
+    test_parse_nesting_depth();
+    test_parse_with_arena();
 
     std::cout << "=== All Parser tests passed! ===\n";
 
@@ -0,0 +1,274 @@
+#include "../include/Lexer.hpp"
+#include "../include/Parser.hpp"
+#include "../include/Plan.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+ConversionPlan compile(const char *input) {
+    Lexer lexer(input);
+    auto tokens = lexer.lex();
+    Parser parser(tokens);
+    auto request = parser.parse();
+    assert(request.has_value());
+    return ConversionPlan::compile(*request);
+}
+
+bool near(float a, float b) { return std::fabs(a - b) <= 1e-4f * std::fabs(b); }
+
+void test_simple_plan() {
+    std::cout << "Test: Simple conversion plan\n";
+    ConversionPlan plan = compile("convert 1.3 kg to lb");
+    float slots[] = {1.3f};
+
+    assert(plan.slotCount() == 1);
+    assert(plan.targetUnit() == "lb");
+    // Un seul arrondi: le résultat exact arrondi en float
+    assert(plan.evaluate(slots) ==
+           static_cast<float>(slots[0] / 0.45359237L));
+    std::cout << "✓ Simple plan test passed\n\n";
+}
+
+void test_expression_plans() {
+    std::cout << "Test: Expression plans\n";
+    float a[] = {5.0f, 11.0f};
+    assert(near(compile("convert 5 ft 11 in to cm").evaluate(a), 180.34f));
+
+    float b[] = {2.0f, 30.0f};
+    assert(near(compile("convert 2 h 30 min to s").evaluate(b), 9000.0f));
+
+    float c[] = {3.0f, 500.0f};
+    assert(near(compile("convert 3 kg + 500 g to g").evaluate(c), 3500.0f));
+
+    float d[] = {2.0f, 3.0f, 500.0f};
+    assert(near(compile("convert 2 * (3 kg - 500 g) to g").evaluate(d),
+                5000.0f));
+
+    float e[] = {1.5f, 2.5f};
+    assert(near(compile("convert (1.5 + 2.5) km to m").evaluate(e),
+                4000.0f));
+    std::cout << "✓ Expression plans test passed\n\n";
+}
+
+void test_temperature_plan() {
+    std::cout << "Test: Temperature plan\n";
+    float slots[] = {40.0f};
+    assert(compile("convert 25 C to F").evaluate(slots) == 104.0f);
+    assert(compile("convert -40 C to F").evaluate(slots) == -40.0f);
+    assert(near(compile("convert 0 K to °C").evaluate(slots), -233.15f));
+    std::cout << "✓ Temperature plan test passed\n\n";
+}
+
+void test_conversion_kinds() {
+    std::cout << "Test: Reciprocal and logarithmic plans\n";
+    float slots[] = {5.0f};
+    // L/100km ↔ mpg: réciproque
+    assert(near(compile("convert 5 km/L to mpg").evaluate(slots), 11.7607f));
+    assert(near(compile("convert 5 mpg to km/L").evaluate(slots), 2.12572f));
+    ConversionPlan economy = compile("convert 5 mpg to km/L, mpg");
+    float out[2];
+    economy.evaluateAll(slots, out);
+    assert(out[1] == 5.0f);
+
+    // Niveaux de puissance
+    float watts[] = {2.0f};
+    assert(near(compile("convert 2 W to dBm").evaluate(watts), 33.0103f));
+    float level[] = {30.0f};
+    assert(near(compile("convert 30 dBm to W").evaluate(level), 1.0f));
+    assert(compile("convert 30 dBm to dBW").evaluate(level) == 0.0f);
+
+    // Expression linéaire vers une cible logarithmique
+    float sum[] = {1.0f, 500.0f};
+    assert(near(compile("convert 1 kW + 500 W to dBW").evaluate(sum),
+                31.7609f));
+
+    // Batch: une boucle par type de cible
+    ConversionPlan mixed = compile("convert 1 W to kW, dBm, W");
+    std::vector<float> in = {1.0f, 10.0f, 100.0f};
+    std::vector<float> batch(3 * in.size());
+    mixed.evaluateBatch(in.data(), in.size(), batch.data());
+    assert(near(batch[3 + 1], 40.0f) && batch[6 + 2] == 100.0f);
+
+    // Hors du domaine: erreur plutôt que -inf, NaN ou inf
+    auto rejects = [](const ConversionPlan &plan, std::vector<float> values) {
+        size_t count = values.size() / plan.slotCount();
+        std::vector<float> results(plan.targetCount() * count);
+        try {
+            plan.evaluateBatch(values.data(), count, results.data());
+        } catch (const std::runtime_error &) {
+            return true;
+        }
+        return false;
+    };
+    assert(rejects(compile("convert 0 W to dBm"), {0.0f}));
+    assert(rejects(compile("convert 0 W to dBm"), {-1.0f}));
+    assert(rejects(compile("convert 0 mpg to L/100km"), {0.0f}));
+    assert(rejects(compile("convert 0 L/100km to km/L"), {0.0f}));
+    assert(rejects(mixed, {1.0f, 0.0f, 2.0f}));
+    assert(rejects(compile("convert 1 kW - 1000 W to dBW"), {1.0f, 1000.0f}));
+    assert(!rejects(compile("convert 0 dBm to W"), {-30.0f, 0.0f}));
+    assert(!rejects(compile("convert 0 km to mi"), {0.0f}));
+
+    // Division par zéro: même erreur de domaine
+    ConversionPlan share = compile("convert 6 km / 2 to m");
+    assert(rejects(share, {6.0f, 8.0f, 0.0f, 2.0f}));
+    assert(rejects(share, {0.0f, 0.0f}));
+    assert(!rejects(share, {0.0f, 8.0f, 1.0f, 4.0f}));
+    assert(rejects(compile("convert 1 km / 1 m * 2 kg to g"),
+                   {1.0f, 0.0f, 2.0f}));
+    std::cout << "✓ Conversion kinds test passed\n\n";
+}
+
+void test_fan_out_plan() {
+    std::cout << "Test: Several target units\n";
+    ConversionPlan plan = compile("convert 100 km/h to m/s, mph, km/h");
+    assert(plan.targetCount() == 3);
+    assert(plan.targetUnit(1) == "mph");
+
+    // Chaque cible vaut la conversion directe vers cette seule unité
+    float slots[] = {100.0f};
+    float out[3];
+    plan.evaluateAll(slots, out);
+    assert(out[0] == compile("convert 100 km/h to m/s").evaluate(slots));
+    assert(out[1] == compile("convert 100 km/h to mph").evaluate(slots));
+    assert(near(out[2], 100.0f));
+    assert(plan.evaluate(slots) == out[0]);
+
+    ConversionPlan temperature = compile("convert 25 C to F, K, C");
+    float t[] = {25.0f};
+    temperature.evaluateAll(t, out);
+    assert(out[0] == 77.0f);
+    assert(out[1] == 298.15f);
+    assert(out[2] == 25.0f);
+
+    // Toutes les cibles doivent avoir la dimension de la source
+    bool thrown = false;
+    try {
+        compile("convert 1 km to m, kg");
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    std::cout << "✓ Fan-out plan test passed\n\n";
+}
+
+void test_invalid_plans() {
+    std::cout << "Test: Dimension errors\n";
+    const char *inputs[] = {"convert 3 kg + 2 m to g",
+                            "convert 3 kg * 2 kg to g",
+                            "convert 2 / 3 kg to g",
+                            "convert 1 mi / 2 ft to m",
+                            "convert 5 C + 3 C to F",
+                            "convert 25 C to m",
+                            "convert 3 kg to m",
+                            "convert (3 kg) g to g",
+                            "convert 2 mpg + 1 mpg to km/L",
+                            "convert 1 dBm * 2 to W"};
+    for (const char *input : inputs) {
+        bool thrown = false;
+        try {
+            compile(input);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    // Requête construite sans le parser: la chaîne de '-' reste bornée
+    Lexer lexer("convert 1 kg to lb");
+    auto tokens = lexer.lex();
+    Parser parser(tokens);
+    auto request = parser.parse();
+    assert(request.has_value());
+    for (size_t i = 0; i <= ConversionPlan::MAX_DEPTH; i++) {
+        request->expression.push_back(
+            ExprNode{ExprNode::Kind::NEG, 0.0f, std::pmr::string()});
+    }
+    bool thrown = false;
+    try {
+        ConversionPlan::compile(*request);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    std::cout << "✓ Dimension errors test passed\n\n";
+}
+
+void test_batch_evaluation() {
+    std::cout << "Test: Batch evaluation\n";
+    ConversionPlan plan = compile("convert 3 kg + 500 g to lb");
+
+    // Colonnes: slot 0 puis slot 1, sur plus d'un bloc
+    const size_t n = 1000;
+    std::vector<float> slots(2 * n);
+    for (size_t i = 0; i < n; i++) {
+        slots[i] = static_cast<float>(i);
+        slots[n + i] = static_cast<float>(2 * i);
+    }
+    std::vector<float> out(n);
+    plan.evaluateBatch(slots.data(), n, out.data());
+
+    for (size_t i = 0; i < n; i++) {
+        float row[] = {slots[i], slots[n + i]};
+        assert(out[i] == plan.evaluate(row));
+    }
+
+    // Plusieurs cibles: une colonne de résultats par cible
+    ConversionPlan fanOut = compile("convert 3 kg + 500 g to lb, oz");
+    std::vector<float> all(2 * n);
+    fanOut.evaluateBatch(slots.data(), n, all.data());
+    for (size_t i = 0; i < n; i++) {
+        float row[] = {slots[i], slots[n + i]};
+        float expected[2];
+        fanOut.evaluateAll(row, expected);
+        assert(all[i] == expected[0] && all[n + i] == expected[1]);
+    }
+    std::cout << "✓ Batch evaluation test passed\n\n";
+}
+
+void test_plan_cache() {
+    std::cout << "Test: Plan cache by shape\n";
+    PlanCache cache;
+
+    Lexer first("convert 1.3 kg to lb");
+    auto firstTokens = first.lex();
+    assert(cache.find(firstTokens) == nullptr);
+
+    Parser parser(firstTokens);
+    cache.insert(firstTokens, ConversionPlan::compile(*parser.parse()));
+
+    // Même forme, autres nombres: pas de reparse
+    Lexer second("convert 7 kg to lb");
+    auto secondTokens = second.lex();
+    const ConversionPlan *plan = cache.find(secondTokens);
+    assert(plan != nullptr);
+
+    float slots[ConversionPlan::MAX_SLOTS];
+    assert(readSlots(secondTokens, slots) == 1);
+    assert(plan->evaluate(slots) == static_cast<float>(7.0L / 0.45359237L));
+
+    // Autre unité: autre forme
+    Lexer third("convert 7 kg to oz");
+    auto thirdTokens = third.lex();
+    assert(cache.find(thirdTokens) == nullptr);
+    assert(cache.size() == 1);
+    std::cout << "✓ Plan cache test passed\n\n";
+}
+
+int main() {
+    std::cout << "=== Plan Tests ===\n\n";
+
+    test_simple_plan();
+    test_expression_plans();
+    test_temperature_plan();
+    test_conversion_kinds();
+    test_fan_out_plan();
+    test_invalid_plans();
+    test_batch_evaluation();
+    test_plan_cache();
+
+    std::cout << "=== All Plan tests passed! ===\n";
+    return 0;
+}
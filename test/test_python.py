@@ -0,0 +1,217 @@
+"""Tests of the convertisseur Python module, on array.array buffers (the
+same buffer protocol as NumPy arrays, without requiring NumPy)."""
+import array
+import struct
+
+import convertisseur as cv
+
+
+def f32(x):
+    """Rounds a Python float to float32."""
+    return struct.unpack("f", struct.pack("f", x))[0]
+
+
+def raises(error, call, *args, **kwargs):
+    try:
+        call(*args, **kwargs)
+    except error:
+        return True
+    return False
+
+
+def test_unit_ids():
+    print("Test: Unit ids")
+    names = cv.units()
+    for i, name in enumerate(names):
+        assert cv.unit_id(name) == i
+        assert cv.unit_name(i) == name
+    assert raises(KeyError, cv.unit_id, "furlong")
+    assert raises(KeyError, cv.unit_name, len(names))
+    assert cv.coefficients("km", "m") == ("linear", 1000.0, 0.0)
+    assert cv.coefficients("°C", "°F") == ("affine", 1.8, 32.0)
+    assert cv.coefficients(cv.unit_id("km"), "m") == cv.coefficients("km", "m")
+    assert raises(ValueError, cv.coefficients, "kg", "m")
+    print("✓ Unit ids test passed\n")
+
+
+def test_convert():
+    print("Test: Conversion of a buffer")
+    values = array.array("f", [float(i) for i in range(1000)])
+    out = array.array("f", bytes(4 * len(values)))
+    cv.convert(values, "km", "m", out)
+    assert list(out) == [f32(x * 1000.0) for x in values]
+
+    cv.convert(values, "°C", "°F", out)
+    for x, y in zip(values, out):
+        assert abs(y - (x * 1.8 + 32.0)) <= 1e-6 * abs(y) + 1e-6
+
+    # Sur place: out est values
+    inplace = array.array("f", values)
+    cv.convert(inplace, "km", "m", inplace)
+    assert inplace == array.array("f", [f32(x * 1000.0) for x in values])
+
+    # Ni copie ni conversion implicite
+    assert raises(ValueError, cv.convert, values, "km", "m", out[:10])
+    assert raises(TypeError, cv.convert, array.array("d", values), "km", "m",
+                  out)
+    assert raises(BufferError, cv.convert, memoryview(values)[::2], "km",
+                  "m", out[:500])
+    assert raises(BufferError, cv.convert, values, "km", "m", bytes(4000))
+    assert raises(ValueError, cv.convert, values, "kg", "m", out)
+    view = memoryview(inplace)
+    assert raises(ValueError, cv.convert, view[1:], "km", "m", view[:-1])
+    print("✓ Convert test passed\n")
+
+
+def test_convert_mixed():
+    print("Test: Rows of mixed unit pairs")
+    pairs = [("km", "mi"), ("kg", "lb"), ("°C", "K"), ("mpg", "L/100km")]
+    values = array.array("f", [0.5 + i for i in range(3001)])
+    from_ids = array.array("H", [cv.unit_id(pairs[i % 4][0])
+                                 for i in range(len(values))])
+    to_ids = array.array("H", [cv.unit_id(pairs[i % 4][1])
+                               for i in range(len(values))])
+    out = array.array("f", bytes(4 * len(values)))
+    cv.convert_mixed(values, from_ids, to_ids, out)
+
+    # Même noyau que convert(): mêmes floats
+    single = array.array("f", [0.0])
+    for i, x in enumerate(values):
+        cv.convert(array.array("f", [x]), from_ids[i], to_ids[i], single)
+        assert out[i] == single[0]
+
+    bad = array.array("H", to_ids)
+    bad[2501] = cv.unit_id("m")  # kg → m
+    assert raises(ValueError, cv.convert_mixed, values, from_ids, bad, out)
+    assert raises(ValueError, cv.convert_mixed, values, from_ids,
+                  to_ids[:10], out)
+
+    # Sur place: une ligne invalide n'écrit aucune ligne
+    inplace = array.array("f", values)
+    assert raises(ValueError, cv.convert_mixed, inplace, from_ids, bad,
+                  inplace)
+    assert inplace == values
+    cv.convert_mixed(inplace, from_ids, to_ids, inplace)
+    assert inplace == out
+
+    # Hors du domaine de la paire: ValueError, out intact
+    power = array.array("f", [1.0, 0.0, -1.0])
+    watt = array.array("H", [cv.unit_id("W")] * 3)
+    dbm = array.array("H", [cv.unit_id("dBm")] * 3)
+    level = array.array("f", bytes(12))
+    assert raises(ValueError, cv.convert_mixed, power, watt, dbm, level)
+    assert raises(ValueError, cv.convert, power, "W", "dBm", level)
+    assert raises(ValueError, cv.convert, array.array("f", [0.0]), "mpg",
+                  "L/100km", level[:1])
+    assert level == array.array("f", bytes(12))
+
+    # Vue décalée: refusée
+    buffer = array.array("f", bytes(4 * 4024))
+    view = memoryview(buffer)
+    assert raises(ValueError, cv.convert_mixed, view[0:3001], from_ids,
+                  to_ids, view[1023:4024])
+    print("✓ Convert mixed test passed\n")
+
+
+def test_storage_formats():
+    print("Test: 16-bit storage formats")
+    values = array.array("f", [0.25 * i for i in range(2000)])
+
+    # float16: mêmes codes que struct "e", arrondi unique depuis le double
+    half = array.array("H", bytes(2 * len(values)))
+    report = cv.convert(values, "km", "mi", half, format="float16")
+    assert report["count"] == len(values) and report["step"] == 0.0
+    scale = cv.coefficients("km", "mi")[1]
+    for x, code in zip(values, half):
+        assert code == struct.unpack("H", struct.pack("e", x * scale))[0]
+    assert 0.0 < report["max_rel_error"] <= 2.0 ** -11
+    assert report["rms_error"] <= report["max_abs_error"]
+
+    # bfloat16: les 16 bits de poids fort d'un float32 (arrondis)
+    brain = array.array("H", bytes(2 * len(values)))
+    report = cv.convert(values, "km", "m", brain, format="bfloat16")
+    for x, code in zip(values, brain):
+        decoded = struct.unpack("f", struct.pack("I", code << 16))[0]
+        assert abs(decoded - x * 1000.0) <= x * 1000.0 * 2.0 ** -8
+    assert report["max_rel_error"] <= 2.0 ** -8
+
+    # fixed16: valeur = code * step, un pas pour le tableau
+    fixed = array.array("h", bytes(2 * len(values)))
+    report = cv.convert(values, "°C", "°F", fixed, format="fixed16")
+    step = report["step"]
+    assert max(abs(c) for c in fixed) * step >= 499.75 * 1.8 + 32.0 - step
+    for x, code in zip(values, fixed):
+        assert abs(code * step - (x * 1.8 + 32.0)) <= step / 2 + 1e-9
+    assert report["max_abs_error"] <= step / 2 and report["overflows"] == 0
+
+    # Lignes mixtes: un rapport par unité cible
+    from_ids = array.array("H", [cv.unit_id("km" if i % 2 else "°C")
+                                 for i in range(len(values))])
+    to_ids = array.array("H", [cv.unit_id("m" if i % 2 else "K")
+                               for i in range(len(values))])
+    reports = cv.convert_mixed(values, from_ids, to_ids, fixed,
+                               format="fixed16")
+    assert sorted(reports) == ["K", "m"]
+    assert reports["m"]["count"] == reports["K"]["count"] == 1000
+    for i, x in enumerate(values):
+        unit = "m" if i % 2 else "K"
+        exact = x * 1000.0 if i % 2 else x + 273.15
+        assert abs(fixed[i] * reports[unit]["step"] - exact) <= \
+            reports[unit]["step"] / 2 + 1e-6
+    reports = cv.convert_mixed(values, from_ids, to_ids, half,
+                               format="float16")
+    assert sum(r["count"] for r in reports.values()) == len(values)
+
+    assert raises(ValueError, cv.convert, values, "km", "m", half,
+                  format="float8")
+    assert raises(TypeError, cv.convert, values, "km", "m", half,
+                  format="fixed16")
+    assert raises(TypeError, cv.convert, values, "km", "m", fixed,
+                  format="float16")
+    view = memoryview(values).cast("B").cast("H")
+    assert raises(ValueError, cv.convert, values, "km", "m", view[:2000],
+                  format="float16")
+    print("✓ Storage formats test passed\n")
+
+
+def test_plan():
+    print("Test: Compiled plans")
+    plan = cv.Plan("convert 1 kg + 1 g to lb, oz")
+    assert plan.slot_count == 2 and plan.targets == ("lb", "oz")
+    assert plan.is_affine
+
+    # slots: les kg de toutes les requêtes, puis tous les g
+    count = 100
+    slots = array.array("f", [float(i) for i in range(count)] +
+                        [float(10 * i) for i in range(count)])
+    out = array.array("f", bytes(4 * 2 * count))
+    plan.evaluate(slots, out)
+    for i in range(count):
+        kg = i + 10 * i / 1000.0
+        assert abs(out[i] - kg / 0.45359237) <= 1e-5 * kg + 1e-6
+        assert abs(out[count + i] - kg / 0.028349523125) <= 1e-5 * kg + 1e-5
+
+    assert cv.Plan("convert 1 kilometers to mi", lenient=True).targets == \
+        ("mi",)
+    assert raises(ValueError, cv.Plan, "convert 1 kg to m")
+    assert raises(ValueError, cv.Plan, "convert to")
+    assert raises(ValueError, plan.evaluate, slots[:-1], out)
+    assert raises(ValueError, plan.evaluate, slots, out[:-1])
+
+    # Hors du domaine de la cible: ValueError, pas de -inf
+    level = cv.Plan("convert 1 W to dBm")
+    assert raises(ValueError, level.evaluate, array.array("f", [1.0, 0.0]),
+                  array.array("f", [0.0, 0.0]))
+    print("✓ Plan test passed\n")
+
+
+if __name__ == "__main__":
+    print("=== Python binding Tests ===\n")
+
+    test_unit_ids()
+    test_convert()
+    test_convert_mixed()
+    test_storage_formats()
+    test_plan()
+
+    print("=== All Python binding tests passed! ===")
@@ -0,0 +1,254 @@
+#include "../include/Convertisseur.hpp"
+#include "../include/Lexer.hpp"
+#include "../include/RequestBatch.hpp"
+#include "../include/Unit.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Même float, bit à bit (les NaN compris)
+bool sameBits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof a) == 0;
+}
+
+UnitId id(std::string_view unit) {
+    auto result = unitId(unit);
+    assert(result.has_value());
+    return *result;
+}
+
+void test_unit_ids() {
+    std::cout << "Test: Unit and pair identifiers\n";
+    for (const auto &[unit, type] : UnitSet) {
+        assert(unitName(id(unit)) == unit);
+    }
+    assert(!unitId("furlong").has_value());
+
+    // Paires denses, une par couple de même dimension
+    std::vector<bool> seen(pairCount());
+    for (const auto &[a, typeA] : UnitSet) {
+        for (const auto &[b, typeB] : UnitSet) {
+            auto pair = pairId(id(a), id(b));
+            assert(pair.has_value() == (typeA == typeB));
+            if (pair.has_value()) {
+                assert(*pair < pairCount() && !seen[*pair]);
+                seen[*pair] = true;
+                Coefficients byId = pairCoefficients(*pair);
+                Coefficients byName = pairCoefficients(a, b);
+                assert(byId.kind == byName.kind &&
+                       byId.scale == byName.scale &&
+                       byId.offset == byName.offset);
+            }
+        }
+    }
+    for (bool s : seen) {
+        assert(s);
+    }
+    std::cout << "✓ Unit ids test passed\n\n";
+}
+
+void test_every_pair() {
+    std::cout << "Test: Batch results equal single conversions\n";
+    // Toutes les paires du registre, deux fois: les lignes d'une paire sont
+    // éloignées dans le lot
+    RequestBatch batch;
+    std::vector<float> expected;
+    std::ostringstream sink;
+    for (int pass = 0; pass < 2; pass++) {
+        for (const auto &[a, typeA] : UnitSet) {
+            for (const auto &[b, typeB] : UnitSet) {
+                // "fl oz" ne se lexe pas en un seul token
+                if (typeA != typeB || a.find(' ') != a.npos ||
+                    b.find(' ') != b.npos) {
+                    continue;
+                }
+                float value = pass == 0 ? 37.5f : 0.0625f;
+                std::string request = "convert " + std::to_string(value) +
+                                      " " + std::string(a) + " to " +
+                                      std::string(b);
+                expected.push_back(Convertisseur(request).convert(sink));
+                assert(batch.push(value, id(a), id(b)));
+            }
+        }
+    }
+    assert(batch.size() == expected.size());
+
+    std::vector<float> out(batch.size());
+    batch.convert(out.data());
+    for (size_t i = 0; i < out.size(); i++) {
+        assert(sameBits(out[i], expected[i]));
+    }
+    std::cout << "✓ Every pair test passed\n\n";
+}
+
+void test_grouping() {
+    std::cout << "Test: Rows come back in order\n";
+    RequestBatch batch;
+    // Paires alternées: chaque groupe est dispersé dans le lot
+    const char *units[][2] = {{"km", "m"}, {"kg", "g"}, {"°C", "°F"},
+                              {"mpg", "L/100km"}};
+    for (int i = 0; i < 1000; i++) {
+        auto &pair = units[i % 4];
+        assert(batch.push(static_cast<float>(i + 1), id(pair[0]),
+                          id(pair[1])));
+    }
+    std::vector<float> out(batch.size());
+    batch.convert(out.data());
+    for (int i = 0; i < 1000; i++) {
+        auto &pair = units[i % 4];
+        Coefficients c = pairCoefficients(pair[0], pair[1]);
+        float expected = 0.0f;
+        float value = static_cast<float>(i + 1);
+        applyCoefficients(c, &value, 1, &expected);
+        assert(sameBits(out[i], expected));
+        assert(batch.valueColumn()[i] == value);
+        assert(unitName(batch.fromColumn()[i]) == pair[0]);
+        assert(unitName(batch.toColumn()[i]) == pair[1]);
+    }
+
+    // Deuxième lot après clear(): d'autres paires, d'autres groupes
+    batch.clear();
+    assert(batch.empty());
+    batch.convert(out.data());
+    assert(batch.push(1.0f, id("mi"), id("km")));
+    assert(batch.push(2.0f, id("km"), id("m")));
+    batch.convert(out.data());
+    assert(out[0] == 1.609344f && out[1] == 2000.0f);
+
+    // Unités de dimensions différentes: rien n'est ajouté
+    assert(!batch.push(1.0f, id("kg"), id("m")));
+    assert(batch.size() == 2);
+
+    // Hors du domaine de la paire, par identifiants aussi: rien n'est
+    // ajouté, même pour une paire déjà dans le lot
+    assert(!batch.push(0.0f, id("W"), id("dBm")));
+    assert(!batch.push(-1.0f, id("W"), id("dBm")));
+    assert(!batch.push(0.0f, id("mpg"), id("L/100km")));
+    assert(batch.push(1.0f, id("W"), id("dBm")));
+    assert(!batch.push(-0.0f, id("W"), id("dBm")));
+    assert(batch.size() == 3);
+    batch.convert(out.data());
+    assert(out[2] == 30.0f);
+    std::cout << "✓ Grouping test passed\n\n";
+}
+
+void test_storage() {
+    std::cout << "Test: 16-bit storage codes\n";
+    RequestBatch batch;
+    const char *units[][2] = {{"km", "m"}, {"mi", "m"}, {"°C", "K"},
+                              {"mpg", "L/100km"}};
+    for (int i = 0; i < 1000; i++) {
+        auto &pair = units[i % 4];
+        assert(batch.push(static_cast<float>(i % 250) * 0.1f, id(pair[0]),
+                          id(pair[1])));
+    }
+    for (StorageFormat format : {StorageFormat::FLOAT16,
+                                 StorageFormat::BFLOAT16,
+                                 StorageFormat::FIXED16}) {
+        std::vector<uint16_t> codes(batch.size());
+        std::vector<ColumnReport> report;
+        batch.convert(format, codes.data(), report);
+
+        // Une colonne par unité cible: m (km et mi), K et L/100km
+        assert(report.size() == 3);
+        assert(report[0].unit < report[1].unit &&
+               report[1].unit < report[2].unit);
+        auto column = [&](const char *unit) -> const PrecisionReport & {
+            for (const ColumnReport &c : report) {
+                if (c.unit == id(unit)) {
+                    return c.precision;
+                }
+            }
+            assert(false);
+            return report[0].precision;
+        };
+        assert(column("m").count == 500 && column("K").count == 250);
+        assert(column("L/100km").count == 250);
+
+        // Même code que le noyau sur une seule valeur
+        double maxError = 0.0;
+        for (int i = 0; i < 1000; i++) {
+            auto &pair = units[i % 4];
+            const PrecisionReport &c = column(pair[1]);
+            float value = batch.valueColumn()[i];
+            uint16_t expected = 0;
+            PrecisionReport single;
+            applyCoefficients(pairCoefficients(pair[0], pair[1]), &value, 1,
+                              format, c.step, &expected, single);
+            assert(codes[i] == expected);
+            if (std::string_view(pair[1]) == "m") {
+                maxError = std::max(single.maxAbsError, maxError);
+            }
+        }
+        assert(maxError == column("m").maxAbsError);
+
+        if (format == StorageFormat::FIXED16) {
+            // Le pas tient le plus grand résultat, 24.9 mi en mètres
+            double largest = 24.9f * 1609.344;
+            assert(largest / column("m").step <= FIXED16_MAX);
+            assert(largest / column("m").step > FIXED16_MAX / 2);
+            assert(column("m").overflows == 0);
+            assert(column("m").maxAbsError <= column("m").step / 2);
+        } else {
+            assert(column("m").step == 0.0);
+        }
+
+        // Codes décodés (--store): deux lots, rapports cumulés par unité
+        std::vector<float> decoded(batch.size());
+        std::vector<PrecisionReport> totals;
+        batch.convertStored(format, decoded.data(), totals);
+        batch.convertStored(format, decoded.data(), totals);
+        assert(totals.size() == UnitSet.size());
+        assert(totals[id("m")].count == 1000 && totals[id("K")].count == 500);
+        assert(totals[id("km")].count == 0);
+        assert(totals[id("m")].maxAbsError == column("m").maxAbsError);
+        assert(totals[id("m")].step == column("m").step);
+        for (int i = 0; i < 1000; i++) {
+            double step = column(units[i % 4][1]).step;
+            assert(decoded[i] == decodeStorage(format, codes[i], step));
+        }
+    }
+    std::cout << "✓ Storage test passed\n\n";
+}
+
+void test_tokens() {
+    std::cout << "Test: Plain requests from tokens\n";
+    RequestBatch batch;
+    auto push = [&](const char *request) {
+        LexerOptions options;
+        options.lenient = true;
+        return batch.push(
+            Lexer(request, std::pmr::get_default_resource(), options).lex());
+    };
+    assert(push("convert 3.5 km to mi"));
+    assert(push("convert 12 Feet to meters"));
+    assert(!push("convert 5 ft 11 in to cm"));
+    assert(!push("convert 100 km/h to mph, knot"));
+    assert(!push("convert -5 °C to F"));
+    assert(!push("convert 3 kg to m"));
+    assert(!push("convert 3 xyz to m"));
+    assert(!push("convert 0 W to dBm"));
+    assert(!push("convert 0 mpg to L/100km"));
+    assert(!push("convert 3 kg"));
+    assert(batch.size() == 2);
+    assert(unitName(batch.fromColumn()[1]) == "ft");
+    assert(unitName(batch.toColumn()[1]) == "m");
+    std::cout << "✓ Tokens test passed\n\n";
+}
+
+int main() {
+    std::cout << "=== RequestBatch Tests ===\n\n";
+
+    test_unit_ids();
+    test_every_pair();
+    test_grouping();
+    test_storage();
+    test_tokens();
+
+    std::cout << "=== All RequestBatch tests passed! ===\n";
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "../include/Resampler.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+bool near(float a, float b) {
+    return std::fabs(a - b) <= 1e-5f * std::max(1.0f, std::fabs(b));
+}
+
+void test_windows() {
+    std::cout << "Test: Fixed windows\n";
+    Resampler resampler("km", "m", 10);
+    int64_t timestamps[] = {0, 3, 9, 10, 15, 42};
+    float values[] = {1.0f, 2.0f, 3.0f, 4.0f, 6.0f, 0.5f};
+
+    std::vector<Window> windows;
+    resampler.push(timestamps, values, 6, windows);
+    // La dernière fenêtre reste ouverte jusqu'à finish()
+    assert(windows.size() == 2);
+    resampler.finish(windows);
+    assert(windows.size() == 3);
+
+    assert(windows[0].start == 0 && windows[0].count == 3);
+    assert(windows[0].mean == 2000.0f);
+    assert(windows[0].min == 1000.0f && windows[0].max == 3000.0f);
+    assert(windows[1].start == 10 && windows[1].mean == 5000.0f);
+    // Fenêtres vides (20, 30) non émises
+    assert(windows[2].start == 40 && windows[2].count == 1);
+    assert(windows[2].min == 500.0f && windows[2].max == 500.0f);
+    std::cout << "✓ Windows test passed\n\n";
+}
+
+void test_matches_per_sample_conversion() {
+    std::cout << "Test: Same result as converting every sample\n";
+    Resampler resampler("F", "K", 60);
+    Resampler direct("F", "K", 1);
+
+    // Plusieurs fenêtres découpées entre plusieurs appels à push
+    const size_t n = 5000;
+    std::vector<int64_t> timestamps(n);
+    std::vector<float> values(n);
+    for (size_t i = 0; i < n; i++) {
+        timestamps[i] = static_cast<int64_t>(i * 7 / 3) - 100;
+        values[i] = static_cast<float>((i * 37) % 200) - 50.0f;
+    }
+
+    std::vector<Window> windows;
+    for (size_t i = 0; i < n; i += 1000) {
+        resampler.push(timestamps.data() + i, values.data() + i, 1000,
+                       windows);
+    }
+    resampler.finish(windows);
+
+    size_t first = 0;
+    for (const Window &w : windows) {
+        std::vector<Window> converted;
+        direct.push(timestamps.data() + first, values.data() + first,
+                    w.count, converted);
+        direct.finish(converted);
+
+        double sum = 0.0;
+        float lo = converted[0].min;
+        float hi = converted[0].max;
+        for (const Window &c : converted) {
+            sum += c.mean * static_cast<double>(c.count);
+            lo = std::min(lo, c.min);
+            hi = std::max(hi, c.max);
+        }
+        assert(w.min == lo && w.max == hi);
+        assert(near(w.mean, static_cast<float>(sum / w.count)));
+        first += w.count;
+    }
+    assert(first == n);
+    assert(windows.front().start == -120);
+    std::cout << "✓ Per-sample equivalence test passed\n\n";
+}
+
+void test_non_affine() {
+    std::cout << "Test: Reciprocal conversion converts samples first\n";
+    Resampler resampler("mpg", "L/100km", 10);
+    int64_t timestamps[] = {0, 1, 2};
+    float values[] = {20.0f, 40.0f, 50.0f};
+
+    std::vector<Window> windows;
+    resampler.push(timestamps, values, 3, windows);
+    resampler.finish(windows);
+    assert(windows.size() == 1);
+
+    // Moyenne des consommations, pas consommation de la moyenne
+    double scale = pairCoefficients("mpg", "L/100km").scale;
+    float expected = static_cast<float>(
+        (scale / 20.0 + scale / 40.0 + scale / 50.0) / 3.0);
+    assert(near(windows[0].mean, expected));
+    // Décroissante: le plus petit mpg donne la plus grande consommation
+    assert(windows[0].max == static_cast<float>(scale / 20.0));
+    assert(windows[0].min == static_cast<float>(scale / 50.0));
+    std::cout << "✓ Non-affine test passed\n\n";
+}
+
+void test_invalid() {
+    std::cout << "Test: Invalid resampling\n";
+    auto throws = [](auto f) {
+        try {
+            f();
+        } catch (const std::runtime_error &) {
+            return true;
+        }
+        return false;
+    };
+
+    assert(throws([] { Resampler("mph", "kg", 60); }));
+    assert(throws([] { Resampler("mph", "m/s", 0); }));
+    assert(throws([] { Resampler("xyz", "m/s", 60); }));
+
+    // Retour à une fenêtre déjà fermée
+    Resampler resampler("psi", "Pa", 10);
+    std::vector<Window> windows;
+    int64_t timestamps[] = {25, 21, 5};
+    float values[] = {1.0f, 2.0f, 3.0f};
+    assert(throws([&] { resampler.push(timestamps, values, 3, windows); }));
+
+    // check(): l'échantillon refusé est écarté, les suivants restent
+    // acceptés
+    Resampler level("W", "dBm", 10);
+    level.check(0, 1.0f);
+    assert(throws([&] { level.check(1, 0.0f); }));
+    assert(throws([&] { level.check(2, -1.0f); }));
+    level.check(12, 2.0f);
+    assert(throws([&] { level.check(5, 1.0f); }));
+    level.check(15, 4.0f);
+    Resampler economy("mpg", "L/100km", 10);
+    assert(throws([&] { economy.check(0, 0.0f); }));
+    economy.check(0, 30.0f);
+    std::cout << "✓ Invalid resampling test passed\n\n";
+}
+
+int main() {
+    std::cout << "=== Resampler Tests ===\n\n";
+
+    test_windows();
+    test_matches_per_sample_conversion();
+    test_non_affine();
+    test_invalid();
+
+    std::cout << "=== All Resampler tests passed! ===\n";
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "../include/ResultCache.hpp"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+const char *CACHE_FILE = "test_resultcache.cache";
+
+void test_chunk_key() {
+    std::cout << "Test: Chunk keys\n";
+    std::string chunk = "convert 1 kg to lb\nconvert 2 m to ft\n";
+    assert(ResultCache::chunkKey(chunk) == ResultCache::chunkKey(chunk));
+    assert(ResultCache::chunkKey(chunk) !=
+           ResultCache::chunkKey("convert 1 kg to lb\n"));
+    // Le mode lenient change la sortie: autre clé
+    assert(ResultCache::chunkKey(chunk, 0) != ResultCache::chunkKey(chunk, 1));
+    std::cout << "✓ Chunk key test passed\n\n";
+}
+
+void test_round_trip() {
+    std::cout << "Test: Results persist across runs\n";
+    std::remove(CACHE_FILE);
+    {
+        ResultCache cache(CACHE_FILE, 42);
+        assert(!cache.find(1).has_value());
+        cache.insert(1, "1 kg = 2.20462 lb\n");
+        cache.insert(7, "2 m = 6.56168 ft\n");
+        // Visible avant l'écriture
+        assert(cache.find(7) == std::string_view("2 m = 6.56168 ft\n"));
+        cache.save();
+        assert(cache.hits() == 1 && cache.misses() == 1);
+    }
+    {
+        ResultCache cache(CACHE_FILE, 42);
+        assert(cache.find(1) == std::string_view("1 kg = 2.20462 lb\n"));
+        assert(cache.find(7) == std::string_view("2 m = 6.56168 ft\n"));
+        assert(!cache.find(3).has_value());
+
+        // Ajout: les anciennes entrées sont conservées
+        cache.insert(3, "");
+        cache.save();
+        assert(cache.find(3) == std::string_view(""));
+    }
+    {
+        ResultCache cache(CACHE_FILE, 42);
+        assert(cache.find(1).has_value() && cache.find(3).has_value());
+    }
+    std::cout << "✓ Round trip test passed\n\n";
+}
+
+void test_registry_version() {
+    std::cout << "Test: Other registry version invalidates the file\n";
+    {
+        ResultCache cache(CACHE_FILE, 43);
+        assert(!cache.find(1).has_value());
+    }
+    std::cout << "✓ Registry version test passed\n\n";
+}
+
+void test_corrupt_file() {
+    std::cout << "Test: Corrupt file is ignored\n";
+    {
+        std::ofstream out(CACHE_FILE, std::ios::binary | std::ios::trunc);
+        out << "CNVCACHE garbage";
+    }
+    {
+        ResultCache cache(CACHE_FILE, 42);
+        assert(!cache.find(1).has_value());
+        cache.insert(1, "ok\n");
+        cache.save();
+    }
+    {
+        ResultCache cache(CACHE_FILE, 42);
+        assert(cache.find(1) == std::string_view("ok\n"));
+    }
+    std::remove(CACHE_FILE);
+    std::cout << "✓ Corrupt file test passed\n\n";
+}
+
+int main() {
+    std::cout << "=== ResultCache Tests ===\n\n";
+
+    test_chunk_key();
+    test_round_trip();
+    test_registry_version();
+    test_corrupt_file();
+
+    std::cout << "=== All ResultCache tests passed! ===\n";
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "../include/Scheduler.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+void test_parallel_for() {
+    std::cout << "Test: Every index processed once\n";
+    for (unsigned workers : {1u, 2u, 4u}) {
+        Scheduler scheduler(workers);
+        assert(scheduler.size() == workers);
+        std::vector<std::atomic<int>> seen(100003);
+        std::atomic<size_t> pieces{0};
+        scheduler.parallelFor(0, seen.size(), 1000,
+                              [&](size_t begin, size_t end) {
+                                  assert(end - begin <= 1000);
+                                  assert(Scheduler::currentWorker() >= 0);
+                                  for (size_t i = begin; i < end; i++) {
+                                      seen[i]++;
+                                  }
+                                  pieces++;
+                              });
+        scheduler.wait();
+        for (auto &count : seen) {
+            assert(count == 1);
+        }
+        // 100003 / 2^7 ≤ 1000: 128 moitiés
+        assert(pieces == 128);
+
+        // Plage vide: aucun appel
+        scheduler.parallelFor(5, 5, 1, [&](size_t, size_t) { assert(false); });
+        scheduler.wait();
+    }
+    assert(Scheduler::currentWorker() == -1);
+    std::cout << "✓ Parallel for test passed\n\n";
+}
+
+// Tâches engendrées par des tâches, à toutes les profondeurs
+void fib(Scheduler &scheduler, int n, std::atomic<uint64_t> &sum) {
+    if (n < 2) {
+        sum += static_cast<uint64_t>(n);
+        return;
+    }
+    scheduler.spawn([&scheduler, n, &sum] { fib(scheduler, n - 1, sum); });
+    fib(scheduler, n - 2, sum);
+}
+
+void test_nested_spawn() {
+    std::cout << "Test: Tasks spawned by tasks\n";
+    Scheduler scheduler(3);
+    for (int round = 0; round < 3; round++) {
+        std::atomic<uint64_t> sum{0};
+        scheduler.spawn([&] { fib(scheduler, 20, sum); });
+        scheduler.wait();
+        assert(sum == 6765);
+    }
+    std::cout << "✓ Nested spawn test passed\n\n";
+}
+
+void test_stats() {
+    std::cout << "Test: Worker counters\n";
+    Scheduler scheduler(4);
+    std::atomic<size_t> pieces{0};
+    scheduler.parallelFor(0, 1 << 16, 64, [&](size_t begin, size_t end) {
+        volatile double x = 0.0;
+        for (size_t i = begin; i < end; i++) {
+            x = x + static_cast<double>(i) * 0.5;
+        }
+        pieces++;
+    });
+    scheduler.wait();
+
+    // Une tâche par moitié engendrée plus la tâche initiale: les feuilles
+    // et les tâches de découpe sont les mêmes
+    uint64_t tasks = 0;
+    for (const auto &worker : scheduler.stats()) {
+        assert(worker.steals <= worker.tasks);
+        assert(worker.busy >= 0.0 && worker.busy <= scheduler.elapsed());
+        tasks += worker.tasks;
+    }
+    assert(pieces == 1024);
+    assert(tasks == 1024);
+    std::cout << "✓ Worker counters test passed\n\n";
+}
+
+void test_exceptions() {
+    std::cout << "Test: Exceptions reach wait()\n";
+    Scheduler scheduler(2);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 10; i++) {
+        scheduler.spawn([&, i] {
+            ran++;
+            if (i == 3) {
+                throw std::runtime_error("échec");
+            }
+        });
+    }
+    bool thrown = false;
+    try {
+        scheduler.wait();
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(ran == 10);
+
+    // L'erreur n'est rapportée qu'une fois
+    scheduler.spawn([] {});
+    scheduler.wait();
+    std::cout << "✓ Exceptions test passed\n\n";
+}
+
+int main() {
+    std::cout << "=== Scheduler Tests ===\n\n";
+
+    test_parallel_for();
+    test_nested_spawn();
+    test_stats();
+    test_exceptions();
+
+    std::cout << "=== All Scheduler tests passed! ===\n";
+    return 0;
+}
@@ -0,0 +1,259 @@
+#include "../include/Plan.hpp"
+#include "../include/ShmRing.hpp"
+#include "../include/Unit.hpp"
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Noms propres au processus: des tests lancés en parallèle ne se gênent pas
+std::string ringName(const char *suffix) {
+    return "/convertisseur-test-" + std::to_string(getpid()) + "-" + suffix;
+}
+
+UnitId id(std::string_view unit) {
+    auto result = unitId(unit);
+    assert(result.has_value());
+    return *result;
+}
+
+bool throws(void (*call)()) {
+    try {
+        call();
+    } catch (const std::runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+void test_push_pop() {
+    std::cout << "Test: Records come out in order\n";
+    std::string name = ringName("order");
+    ShmRing producer = ShmRing::create(name, 8);
+    ShmRing consumer = ShmRing::attach(name);
+    ShmRing::remove(name);
+    assert(consumer.capacity() == 8 && consumer.writable() == 8);
+
+    // Plusieurs tours: les positions dépassent la capacité
+    SampleRecord out[8];
+    float next = 0.0f;
+    float expected = 0.0f;
+    for (int round = 0; round < 10; round++) {
+        while (producer.push(SampleRecord{next, 1, 2})) {
+            next += 1.0f;
+        }
+        assert(producer.writable() == 0 && consumer.readable() == 8);
+        size_t n = consumer.pop(out, 5);
+        assert(n == 5);
+        n += consumer.pop(out + 5, 8);
+        assert(n == 8);
+        for (const SampleRecord &r : out) {
+            assert(r.value == expected && r.from == 1 && r.to == 2);
+            expected += 1.0f;
+        }
+    }
+    assert(consumer.pop(out, 8) == 0);
+    assert(!consumer.closed());
+    producer.close();
+    assert(consumer.closed());
+    std::cout << "✓ Push/pop test passed\n\n";
+}
+
+void test_producers() {
+    std::cout << "Test: Several producers\n";
+    std::string name = ringName("mpsc");
+    ShmRing consumer = ShmRing::create(name, 64);
+    constexpr int PRODUCERS = 4;
+    constexpr int RECORDS = 20000;
+
+    // Chaque producteur a sa propre projection, comme un autre processus;
+    // from porte son numéro, value son compteur
+    std::vector<std::thread> threads;
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([ring = ShmRing::attach(name), p]() mutable {
+            for (int i = 0; i < RECORDS; i++) {
+                SampleRecord r{static_cast<float>(i), static_cast<UnitId>(p),
+                               0};
+                while (!ring.push(r)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    ShmRing::remove(name);
+
+    std::vector<float> last(PRODUCERS, -1.0f);
+    SampleRecord out[64];
+    int received = 0;
+    while (received < PRODUCERS * RECORDS) {
+        size_t n = consumer.pop(out, 64);
+        for (size_t i = 0; i < n; i++) {
+            // L'ordre de chaque producteur est conservé
+            assert(out[i].value == last[out[i].from] + 1.0f);
+            last[out[i].from] = out[i].value;
+        }
+        received += static_cast<int>(n);
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    assert(consumer.readable() == 0);
+    std::cout << "✓ Producers test passed\n\n";
+}
+
+void test_converter() {
+    std::cout << "Test: Converter between two rings\n";
+    std::string inName = ringName("in");
+    std::string outName = ringName("out");
+    ShmRing input = ShmRing::create(inName, 256);
+    ShmRing output = ShmRing::create(outName, 256);
+    ShmRing::remove(inName);
+    ShmRing::remove(outName);
+
+    // Plus de records que les deux anneaux n'en tiennent: le convertisseur
+    // attend que la sortie soit lue
+    constexpr int RECORDS = 5000;
+    const UnitId pairs[][2] = {{id("km"), id("mi")},
+                               {id("°C"), id("°F")},
+                               {id("kg"), id("m")},
+                               {id("mpg"), id("L/100km")}};
+    std::thread producer([&] {
+        for (int i = 0; i < RECORDS; i++) {
+            const UnitId *pair = pairs[i % 4];
+            while (!input.push(SampleRecord{static_cast<float>(i) + 0.5f,
+                                            pair[0], pair[1]})) {
+                std::this_thread::yield();
+            }
+        }
+        input.close();
+    });
+
+    uint64_t converted = 0;
+    std::thread converter(
+        [&] { converted = RingConverter(input, output).run(); });
+
+    int received = 0;
+    SampleRecord out[100];
+    while (!(output.closed() && output.readable() == 0)) {
+        size_t n = output.pop(out, 100);
+        for (size_t k = 0; k < n; k++, received++) {
+            const UnitId *pair = pairs[received % 4];
+            float value = static_cast<float>(received) + 0.5f;
+            assert(out[k].to == pair[1]);
+            if (received % 4 == 2) {
+                // kg → m: rendu tel quel, marqué invalide
+                assert(out[k].from == INVALID_UNIT && out[k].value == value);
+                continue;
+            }
+            // Même noyau que le mode texte
+            float expected = 0.0f;
+            applyCoefficients(pairCoefficients(*pairId(pair[0], pair[1])),
+                              &value, 1, &expected);
+            assert(out[k].from == pair[0]);
+            assert(std::memcmp(&out[k].value, &expected, sizeof expected) ==
+                   0);
+        }
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    converter.join();
+    assert(received == RECORDS && converted == RECORDS);
+
+    // Hors du domaine de la paire: rendu tel quel, marqué invalide
+    ShmRing requests = ShmRing::create(inName, 8);
+    ShmRing results = ShmRing::create(outName, 8);
+    ShmRing::remove(inName);
+    ShmRing::remove(outName);
+    const SampleRecord domain[] = {{0.0f, id("W"), id("dBm")},
+                                   {-1.0f, id("W"), id("dBm")},
+                                   {0.0f, id("mpg"), id("L/100km")},
+                                   {1.0f, id("W"), id("dBm")}};
+    for (const SampleRecord &r : domain) {
+        assert(requests.push(r));
+    }
+    assert(RingConverter(requests, results).step() == 4);
+    assert(results.pop(out, 100) == 4);
+    for (int k = 0; k < 3; k++) {
+        assert(out[k].from == INVALID_UNIT);
+        assert(out[k].value == domain[k].value);
+    }
+    assert(out[3].from == id("W") && out[3].value == 30.0f);
+
+    // Stockage float16: le code décodé est publié, l'erreur rapportée
+    RingConverter stored(requests, results, StorageFormat::FLOAT16);
+    assert(requests.push(SampleRecord{100.0f, id("km"), id("mi")}));
+    assert(stored.step() == 1 && results.pop(out, 100) == 1);
+    assert(out[0].from == id("km") && out[0].value == 62.125f);
+    const PrecisionReport &mi = stored.reports()[id("mi")];
+    assert(mi.count == 1 && mi.maxAbsError > 0.0);
+    std::cout << "✓ Converter test passed\n\n";
+}
+
+void test_errors() {
+    std::cout << "Test: Invalid rings\n";
+    assert(throws([] { ShmRing::attach(ringName("missing")); }));
+    assert(throws([] { ShmRing::create(ringName("size"), 12); }));
+
+    // Nom déjà pris
+    static std::string name = ringName("exists");
+    ShmRing ring = ShmRing::create(name, 4);
+    assert(throws([] { ShmRing::create(name, 4); }));
+    ShmRing::remove(name);
+
+    // Un objet qui n'est pas un anneau
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    assert(fd >= 0 && ftruncate(fd, 4096) == 0);
+    close(fd);
+    assert(throws([] { ShmRing::attach(name); }));
+    ShmRing::remove(name);
+
+    // Capacité qui n'est pas une puissance de deux, taille cohérente: la
+    // taille d'un slot vient de deux anneaux valides
+    auto size = [](size_t capacity) {
+        ShmRing valid = ShmRing::create(name, capacity);
+        struct stat st {};
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        assert(fd >= 0 && fstat(fd, &st) == 0);
+        close(fd);
+        ShmRing::remove(name);
+        return static_cast<off_t>(st.st_size);
+    };
+    off_t slot = (size(4) - size(2)) / 2;
+    off_t header = size(2) - 2 * slot;
+    for (uint32_t capacity : {0u, 1u, 3u}) {
+        ShmRing valid = ShmRing::create(name, 4);
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        // magic[8] puis version: capacity à l'octet 12
+        assert(fd >= 0 &&
+               pwrite(fd, &capacity, sizeof capacity, 12) == sizeof capacity &&
+               ftruncate(fd, header + capacity * slot) == 0);
+        close(fd);
+        assert(throws([] { ShmRing::attach(name); }));
+        ShmRing::remove(name);
+    }
+    std::cout << "✓ Errors test passed\n\n";
+}
+
+int main() {
+    std::cout << "=== ShmRing Tests ===\n\n";
+
+    test_push_pop();
+    test_producers();
+    test_converter();
+    test_errors();
+
+    std::cout << "=== All ShmRing tests passed! ===\n";
+    return 0;
+}
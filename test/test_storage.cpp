@@ -0,0 +1,155 @@
+#include "../include/Storage.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+// Arrondi de référence d'un format binaire de 16 bits: entier le plus proche
+// de value / unité (pair en cas d'égalité), unité fixée par l'exposant
+template <int EXP, int MAN> double referenceRound(double value) {
+    constexpr int BIAS = (1 << (EXP - 1)) - 1;
+    const double largest = std::ldexp(2.0 - std::ldexp(1.0, -MAN), BIAS);
+    int exponent = 0;
+    std::frexp(value, &exponent);
+    // Unité de la mantisse, pas plus fine que celle des sous-normaux
+    int unit = std::max(exponent - 1, 1 - BIAS) - MAN;
+    double rounded = std::ldexp(
+        std::nearbyint(std::ldexp(value, -unit)), unit);
+    // Au-delà de largest + une demi-unité de largest: infini
+    double limit = largest + std::ldexp(1.0, BIAS - MAN - 1);
+    if (std::fabs(value) >= limit) {
+        return std::copysign(HUGE_VAL, value);
+    }
+    return rounded;
+}
+
+template <int EXP, int MAN> void checkRound(double value) {
+    uint16_t code = roundBinary16<EXP, MAN>(value);
+    double decoded = expandBinary16<EXP, MAN>(code);
+    double expected = referenceRound<EXP, MAN>(value);
+    assert(decoded == expected);
+    assert(std::signbit(decoded) == std::signbit(value));
+}
+
+// Les virgules des arguments de template gênent assert()
+uint16_t half(double value) { return roundBinary16<5, 10>(value); }
+uint16_t brain(double value) { return roundBinary16<8, 7>(value); }
+double fromHalf(uint16_t code) { return expandBinary16<5, 10>(code); }
+double fromBrain(uint16_t code) { return expandBinary16<8, 7>(code); }
+
+void test_binary16() {
+    std::cout << "Test: Rounding to float16 and bfloat16\n";
+    using F16 = StorageFormat;
+    // Valeurs exactes, limites et égalités
+    assert(half(1.0) == 0x3C00);
+    assert(half(-2.0) == 0xC000);
+    assert(half(65504.0) == 0x7BFF);
+    assert(half(65519.99) == 0x7BFF);
+    assert(half(65520.0) == 0x7C00);
+    assert(half(1.0 + std::ldexp(1.0, -11)) == 0x3C00);
+    assert(half(1.0 + 3 * std::ldexp(1.0, -11)) == 0x3C02);
+    assert(half(std::ldexp(1.0, -24)) == 0x0001);
+    assert(half(std::ldexp(1.0, -25)) == 0x0000);
+    assert(half(std::ldexp(1.5, -25)) == 0x0001);
+    assert(half(-0.0) == 0x8000);
+    assert(brain(1.0) == 0x3F80);
+    assert(brain(3.0e38) == 0x7F62);
+    assert(brain(1.0e39) == 0x7F80);
+    assert(std::isnan(decodeStorage<F16::FLOAT16>(
+        encodeStorage<F16::FLOAT16>(NAN, 0.0), 0.0)));
+    assert(std::isnan(decodeStorage(
+        F16::BFLOAT16, encodeStorage<F16::BFLOAT16>(NAN, 0.0), 0.0)));
+    assert(decodeStorage<F16::FLOAT16>(
+               encodeStorage<F16::FLOAT16>(-HUGE_VAL, 0.0), 0.0) == -HUGE_VAL);
+
+    // Tous les codes finis se décodent puis se réencodent à l'identique
+    for (uint32_t code = 0; code < 0x10000; code++) {
+        auto c = static_cast<uint16_t>(code);
+        assert(std::isnan(fromHalf(c)) || half(fromHalf(c)) == c);
+        assert(std::isnan(fromBrain(c)) || brain(fromBrain(c)) == c);
+    }
+
+    // Valeurs aléatoires sur toute l'étendue, contre la référence
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<double> mantissa(-2.0, 2.0);
+    std::uniform_int_distribution<int> exponent(-150, 140);
+    for (int i = 0; i < 200000; i++) {
+        double value = std::ldexp(mantissa(random), exponent(random));
+        checkRound<5, 10>(value);
+        checkRound<8, 7>(value);
+#ifdef __FLT16_MAX__
+        // Même arrondi que le type du compilateur, s'il existe
+        auto native = static_cast<_Float16>(value);
+        assert(static_cast<double>(native) == fromHalf(half(value)));
+#endif
+    }
+    std::cout << "✓ Binary16 test passed\n\n";
+}
+
+void test_fixed16() {
+    std::cout << "Test: Fixed-point codes\n";
+    // Pas: la plus petite puissance de deux qui tient la borne
+    assert(fixedStep(0.0) == 1.0);
+    assert(fixedStep(HUGE_VAL) == 1.0);
+    assert(fixedStep(NAN) == 1.0);
+    assert(fixedStep(32767.0) == 1.0);
+    assert(fixedStep(32767.5) == 2.0);
+    assert(fixedStep(0.999) == std::ldexp(1.0, -15));
+    assert(fixedStep(1.0) == std::ldexp(1.0, -14));
+    for (double bound = 1e-30; bound < 1e30; bound *= 1.37) {
+        double step = fixedStep(bound);
+        int exponent = 0;
+        assert(std::frexp(step, &exponent) == 0.5);
+        assert(bound / step <= FIXED16_MAX);
+        assert(bound / (step / 2) > FIXED16_MAX);
+    }
+
+    constexpr auto FIXED16 = StorageFormat::FIXED16;
+    double step = 0.25;
+    auto roundTrip = [&](double value) {
+        return decodeStorage<FIXED16>(encodeStorage<FIXED16>(value, 1 / step),
+                                      step);
+    };
+    assert(roundTrip(3.0) == 3.0);
+    assert(roundTrip(3.1) == 3.0);
+    assert(roundTrip(-3.2) == -3.25);
+    assert(roundTrip(0.125) == 0.0);  // égalité: code pair
+    assert(roundTrip(0.375) == 0.5);
+    assert(roundTrip(1e9) == FIXED16_MAX * step);
+    assert(roundTrip(-1e9) == -FIXED16_MAX * step);
+    assert(roundTrip(-HUGE_VAL) == -FIXED16_MAX * step);
+    assert(encodeStorage<FIXED16>(NAN, 4.0) == FIXED16_NAN);
+    assert(std::isnan(roundTrip(NAN)));
+    std::cout << "✓ Fixed16 test passed\n\n";
+}
+
+void test_report() {
+    std::cout << "Test: Precision reports\n";
+    PrecisionReport a;
+    assert(a.rmsError() == 0.0);
+    a.count = 2;
+    a.sumSquares = 8.0;
+    a.maxAbsError = 2.0;
+    PrecisionReport b;
+    b.count = 2;
+    b.maxRelError = 0.5;
+    b.overflows = 1;
+    a.merge(b);
+    assert(a.count == 4 && a.rmsError() == std::sqrt(2.0));
+    assert(a.maxAbsError == 2.0 && a.maxRelError == 0.5);
+    assert(a.overflows == 1);
+    std::cout << "✓ Report test passed\n\n";
+}
+
+int main() {
+    std::cout << "=== Storage Tests ===\n\n";
+
+    test_binary16();
+    test_fixed16();
+    test_report();
+
+    std::cout << "=== All Storage tests passed! ===\n";
+    return 0;
+}
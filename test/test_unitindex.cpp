@@ -0,0 +1,165 @@
+#include "../include/UnitIndex.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+void test_registry_tables() {
+    std::cout << "Test: Constant registry tables\n";
+    assert(UnitSet.find("kg")->second == UnitType::WEIGHT);
+    assert(UnitSet.find("μm")->second == UnitType::DISTANCE);
+    assert(UnitSet.find("KG") == UnitSet.end());
+    // Définition légale exacte
+    assert(UnitFactors.at("lb") == 0.45359237);
+    assert(UnitAliases.at("feet") == "ft");
+
+    // Seules les unités linéaires ont un facteur vers l'unité de base
+    for (const auto &[unit, type] : UnitSet) {
+        bool hasFactor = UnitFactors.find(unit) != UnitFactors.end();
+        bool linear = pairCoefficients(unit, baseUnit(type)).kind ==
+                      ConversionKind::LINEAR;
+        assert(hasFactor == linear);
+    }
+    assert(baseUnit(UnitType::WEIGHT) == "kg");
+    assert(baseUnit(UnitType::TEMPERATURE) == "K");
+    assert(baseUnit(UnitType::FUEL_ECONOMY) == "L/100km");
+
+    bool thrown = false;
+    try {
+        (void)UnitFactors.at("°C");
+    } catch (const std::out_of_range &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Coefficients par paire, calculés à la compilation
+    assert(pairCoefficients("lb", "kg").scale == 0.45359237);
+    assert(pairCoefficients("kg", "kg").scale == 1.0);
+    assert(pairCoefficients("°C", "K").offset == 273.15);
+    assert(pairCoefficients("K", "°F").scale == 1.8);
+    assert(pairCoefficients("°C", "°C").kind == ConversionKind::LINEAR);
+
+    // Autres types de conversion
+    Coefficients economy = pairCoefficients("mpg", "L/100km");
+    assert(economy.kind == ConversionKind::RECIPROCAL);
+    assert(economy.scale == static_cast<double>(378.5411784L / 1.609344L));
+    assert(pairCoefficients("mpg", "km/L").kind == ConversionKind::LINEAR);
+    assert(pairCoefficients("W", "dBm").kind == ConversionKind::LOGARITHMIC);
+    assert(pairCoefficients("W", "dBm").offset == 30.0);
+    assert(pairCoefficients("dBm", "kW").kind == ConversionKind::EXPONENTIAL);
+    Coefficients level = pairCoefficients("dBW", "dBm");
+    assert(level.kind == ConversionKind::AFFINE);
+    assert(level.scale == 1.0 && level.offset == 30.0);
+    thrown = false;
+    try {
+        (void)pairCoefficients("kg", "m");
+    } catch (const std::out_of_range &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Recherche à la compilation
+    constexpr UnitEntry<int> rows[] = {{"b", 2}, {"c", 3}, {"a", 1}};
+    static constexpr auto sorted = sortedTable(rows);
+    constexpr UnitTable<int> table(sorted);
+    static_assert(table.find("c")->second == 3);
+    static_assert(table.find("d") == table.end());
+    std::cout << "✓ Registry tables test passed\n\n";
+}
+
+void test_distance() {
+    std::cout << "Test: Edit distance\n";
+    assert(UnitIndex::distance("kPa", "kPa") == 0);
+    assert(UnitIndex::distance("kpa", "kPa") == 1);
+    assert(UnitIndex::distance("kPa", "Pa") == 1);
+    assert(UnitIndex::distance("", "mph") == 3);
+    // Les caractères multi-octets comptent pour un seul point de code
+    assert(UnitIndex::distance("μm", "um") == 1);
+    assert(UnitIndex::distance("m²", "m2") == 1);
+    std::cout << "✓ Distance test passed\n\n";
+}
+
+void test_resolve() {
+    std::cout << "Test: Case-insensitive and alias lookup\n";
+    const UnitIndex &index = UnitIndex::global();
+
+    assert(index.resolve("kPa") == "kPa");
+    assert(index.resolve("KPA") == "kPa");
+    assert(index.resolve("feet") == "ft");
+    assert(index.resolve("Kilometers") == "km");
+    assert(index.resolve("ML") == "ml");
+    assert(!index.resolve("parsec").has_value());
+    std::cout << "✓ Resolve test passed\n\n";
+}
+
+void test_suggest() {
+    std::cout << "Test: Suggestions\n";
+    const UnitIndex &index = UnitIndex::global();
+
+    auto suggestions = index.suggest("kpa");
+    assert(!suggestions.empty());
+    assert(suggestions[0] == "kPa");
+
+    suggestions = index.suggest("poundz");
+    assert(!suggestions.empty());
+    assert(suggestions[0] == "lb");
+
+    suggestions = index.suggest("mphh", 1);
+    assert(suggestions.size() == 1);
+    assert(suggestions[0] == "mph");
+
+    assert(index.suggest("zzzzzzzz").empty());
+
+    // Mot très long: rejeté sans générer ses variantes
+    auto start = std::chrono::steady_clock::now();
+    assert(index.suggest(std::string(100000, 'k')).empty());
+    assert(index.suggest(std::string(2000, 'm') + "ph").empty());
+    assert(std::chrono::steady_clock::now() - start <
+           std::chrono::milliseconds(100));
+    std::cout << "✓ Suggest test passed\n\n";
+}
+
+void test_closest() {
+    std::cout << "Test: Unique closest unit\n";
+    const UnitIndex &index = UnitIndex::global();
+
+    assert(index.closest("kgg") == "kg");
+    assert(index.closest("inchs") == "in");
+    // "x" est à distance 1 de m, g, s...: ambigu
+    assert(!index.closest("x").has_value());
+    std::cout << "✓ Closest test passed\n\n";
+}
+
+void test_query_speed() {
+    std::cout << "Test: Query speed\n";
+    const UnitIndex &index = UnitIndex::global();
+
+    constexpr int N = 100000;
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; i++) {
+        found += index.suggest(i % 2 ? "kpa" : "galon", 1).size();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    assert(found > 0);
+    std::cout << "  "
+              << std::chrono::duration<double, std::nano>(elapsed).count() / N
+              << " ns/query\n";
+    std::cout << "✓ Query speed test passed\n\n";
+}
+
+int main() {
+    std::cout << "=== UnitIndex Tests ===\n\n";
+
+    test_registry_tables();
+    test_distance();
+    test_resolve();
+    test_suggest();
+    test_closest();
+    test_query_speed();
+
+    std::cout << "=== All UnitIndex tests passed! ===\n";
+    return 0;
+}